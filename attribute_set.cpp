@@ -0,0 +1,118 @@
+#include "attribute_set.hpp"
+
+constexpr int AttributeSet::word_bits;
+
+namespace {
+
+bool has_member_above(const AttributeSet& set, int id) {
+    int word = id / AttributeSet::word_bits;
+    int bit = id % AttributeSet::word_bits;
+    AttributeSet::Word mask = (bit + 1 == AttributeSet::word_bits) ? 
+        0 : ~AttributeSet::Word{0} << (bit + 1);
+    if (set.data()[word] & mask)
+        return true;
+    for (int i = word + 1; i < set.word_count(); i++) {
+        if (set.data()[i] != 0)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool AttributeSet::operator < (const AttributeSet& other) const {
+    for (int i = 0; i < word_count(); i++) {
+        Word diff = words_[i] ^ other.words_[i];
+        if (diff == 0)
+            continue;
+
+        int first_diff = i * word_bits + __builtin_ctzll(diff);
+        if (contains(first_diff))
+            return has_member_above(other, first_diff);
+        else
+            return !has_member_above(*this, first_diff);
+    }
+    return false;
+}
+
+std::size_t AttributeSet::hash() const {
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (auto w: words_) {
+        h ^= w + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    }
+    return static_cast<std::size_t>(h);
+}
+
+// Schema
+Schema::Schema(const FieldSet& U) {
+    for (auto& field: U) {
+        add(field);
+    }
+}
+
+int Schema::add(const Field& field) {
+    auto it = ids_.find(field.id());
+    if (it != ids_.end())
+        return it->second;
+
+    int id = size();
+    fields_.push_back(field);
+    ids_.emplace(field.id(), id);
+    return id;
+}
+
+int Schema::id_of(const Field& field) const {
+    auto it = ids_.find(field.id());
+    if (it == ids_.end())
+        return -1;
+    return it->second;
+}
+
+AttributeSet Schema::all() const {
+    AttributeSet result = empty_set();
+    for (int id = 0; id < size(); id++) {
+        result.insert(id);
+    }
+    return result;
+}
+
+AttributeSet Schema::encode(const FieldSet& set) const {
+    AttributeSet result = empty_set();
+    for (auto& field: set) {
+        result.insert(ids_.at(field.id()));
+    }
+    return result;
+}
+
+AttributeFD Schema::encode(const FD& fd) const {
+    return AttributeFD{encode(fd.first), encode(fd.second)};
+}
+
+AttributeFDSet Schema::encode(const FDSet& fds) const {
+    AttributeFDSet result;
+    result.reserve(fds.size());
+    for (auto& fd: fds) {
+        result.push_back(encode(fd));
+    }
+    return result;
+}
+
+FieldSet Schema::decode(const AttributeSet& set) const {
+    FieldSet result;
+    set.for_each([this, &result](int id) {
+        result.insert(result.end(), fields_[id]);
+    });
+    return result;
+}
+
+FD Schema::decode(const AttributeFD& fd) const {
+    return FD{decode(fd.first), decode(fd.second)};
+}
+
+FDSet Schema::decode(const AttributeFDSet& fds) const {
+    FDSet result;
+    for (auto& fd: fds) {
+        result.insert(decode(fd));
+    }
+    return result;
+}
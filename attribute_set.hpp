@@ -0,0 +1,280 @@
+#ifndef DB_ATTRIBUTE_SET_HPP
+#define DB_ATTRIBUTE_SET_HPP
+
+#include "util.hpp"
+#include "instrumentation.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Dense bitset over the attribute ids of a Schema.
+// Binary operations expect both operands to be built against the same schema.
+class AttributeSet {
+public:
+    using Word = std::uint64_t;
+    static constexpr int word_bits = 64;
+
+private:
+    std::vector<Word> words_;
+    int universe_size_ = 0;
+
+    static int word_count_of(int universe_size) {
+        return (universe_size + word_bits - 1) / word_bits;
+    }
+
+public:
+    AttributeSet() = default;
+
+    explicit AttributeSet(int universe_size)
+        : words_(word_count_of(universe_size), 0),
+        universe_size_{universe_size} {
+        DB_COUNT(set_allocations, !words_.empty());
+    }
+
+#ifdef DB_INSTRUMENTATION
+    // Copies that allocate are counted too
+    AttributeSet(const AttributeSet& other)
+        : words_(other.words_), universe_size_{other.universe_size_} {
+        DB_COUNT(set_allocations, !words_.empty());
+    }
+
+    AttributeSet(AttributeSet&&) = default;
+
+    AttributeSet& operator = (const AttributeSet& other) {
+        DB_COUNT(set_allocations, words_.capacity() < other.words_.size());
+        words_ = other.words_;
+        universe_size_ = other.universe_size_;
+        return *this;
+    }
+
+    AttributeSet& operator = (AttributeSet&&) = default;
+#endif
+
+    int universe_size() const {
+        return universe_size_;
+    }
+
+    int word_count() const {
+        return static_cast<int>(words_.size());
+    }
+
+    const Word *data() const {
+        return words_.data();
+    }
+
+    Word *data() {
+        return words_.data();
+    }
+
+    void insert(int id) {
+        words_[id / word_bits] |= Word{1} << (id % word_bits);
+    }
+
+    void erase(int id) {
+        words_[id / word_bits] &= ~(Word{1} << (id % word_bits));
+    }
+
+    bool contains(int id) const {
+        return (words_[id / word_bits] >> (id % word_bits)) & 1;
+    }
+
+    void clear() {
+        std::fill(words_.begin(), words_.end(), 0);
+    }
+
+    bool empty() const {
+        for (auto w: words_) {
+            if (w != 0)
+                return false;
+        }
+        return true;
+    }
+
+    int size() const {
+        int result = 0;
+        for (auto w: words_) {
+            result += __builtin_popcountll(w);
+        }
+        return result;
+    }
+
+    // Calls f(id) for every member in increasing id order.
+    template <typename Func>
+    void for_each(Func&& f) const {
+        for (int i = 0; i < word_count(); i++) {
+            Word w = words_[i];
+            while (w != 0) {
+                int bit = __builtin_ctzll(w);
+                f(i * word_bits + bit);
+                w &= w - 1;
+            }
+        }
+    }
+
+    // Smallest member not less than id, -1 when there is none.
+    int next(int id) const {
+        if (id >= universe_size_)
+            return -1;
+        int i = id / word_bits;
+        Word w = words_[i] & (~Word{0} << (id % word_bits));
+        while (w == 0) {
+            if (++i == word_count())
+                return -1;
+            w = words_[i];
+        }
+        return i * word_bits + __builtin_ctzll(w);
+    }
+
+    AttributeSet& operator |= (const AttributeSet& other) {
+        for (int i = 0; i < word_count(); i++) {
+            words_[i] |= other.words_[i];
+        }
+        return *this;
+    }
+
+    AttributeSet& operator &= (const AttributeSet& other) {
+        for (int i = 0; i < word_count(); i++) {
+            words_[i] &= other.words_[i];
+        }
+        return *this;
+    }
+
+    AttributeSet& operator -= (const AttributeSet& other) {
+        for (int i = 0; i < word_count(); i++) {
+            words_[i] &= ~other.words_[i];
+        }
+        return *this;
+    }
+
+    bool is_subset_of(const AttributeSet& other) const {
+        for (int i = 0; i < word_count(); i++) {
+            if (words_[i] & ~other.words_[i])
+                return false;
+        }
+        return true;
+    }
+
+    int intersection_size(const AttributeSet& other) const {
+        int result = 0;
+        for (int i = 0; i < word_count(); i++) {
+            result += __builtin_popcountll(words_[i] & other.words_[i]);
+        }
+        return result;
+    }
+
+    bool intersects(const AttributeSet& other) const {
+        for (int i = 0; i < word_count(); i++) {
+            if (words_[i] & other.words_[i])
+                return true;
+        }
+        return false;
+    }
+
+    bool operator == (const AttributeSet& other) const {
+        return words_ == other.words_;
+    }
+
+    bool operator != (const AttributeSet& other) const {
+        return !(*this == other);
+    }
+
+    // Same order as std::set<Field>: lexicographic over the sorted members.
+    bool operator < (const AttributeSet& other) const;
+
+    std::size_t hash() const;
+};
+
+namespace std {
+
+template <>
+struct hash<AttributeSet> {
+    std::size_t operator () (const AttributeSet& set) const {
+        return set.hash();
+    }
+};
+
+} // namespace std
+
+inline bool is_subset(const AttributeSet& set1, const AttributeSet& set2) {
+    return set1.is_subset_of(set2);
+}
+
+inline bool set_contains(const AttributeSet& set, int id) {
+    return set.contains(id);
+}
+
+inline AttributeSet operator + (const AttributeSet& set1, const AttributeSet& set2) {
+    AttributeSet result = set1;
+    result |= set2;
+    return result;
+}
+
+inline AttributeSet operator - (const AttributeSet& set1, const AttributeSet& set2) {
+    AttributeSet result = set1;
+    result -= set2;
+    return result;
+}
+
+inline AttributeSet operator * (const AttributeSet& set1, const AttributeSet& set2) {
+    AttributeSet result = set1;
+    result &= set2;
+    return result;
+}
+
+inline AttributeSet& operator += (AttributeSet& set1, const AttributeSet& set2) {
+    return set1 |= set2;
+}
+
+using AttributeFD = std::pair<AttributeSet, AttributeSet>;
+
+using AttributeFDSet = std::vector<AttributeFD>;
+
+// Assigns dense ids to fields.
+// Ids follow the order in which fields are added, so a schema built from
+// a FieldSet keeps the ordering of Field and encoding a FDSet gives a
+// sorted AttributeFDSet.
+class Schema {
+private:
+    std::vector<Field> fields_;
+    // Keyed by Field::id, lookups do not compare names
+    std::unordered_map<int, int> ids_;
+
+public:
+    Schema() = default;
+
+    explicit Schema(const FieldSet& U);
+
+    int add(const Field& field);
+
+    // Returns -1 when the field is not in the schema
+    int id_of(const Field& field) const;
+
+    const Field& field_of(int id) const {
+        return fields_[id];
+    }
+
+    int size() const {
+        return static_cast<int>(fields_.size());
+    }
+
+    AttributeSet empty_set() const {
+        return AttributeSet(size());
+    }
+
+    AttributeSet all() const;
+
+    AttributeSet encode(const FieldSet& set) const;
+
+    AttributeFD encode(const FD& fd) const;
+
+    AttributeFDSet encode(const FDSet& fds) const;
+
+    FieldSet decode(const AttributeSet& set) const;
+
+    FD decode(const AttributeFD& fd) const;
+
+    FDSet decode(const AttributeFDSet& fds) const;
+};
+
+#endif
@@ -0,0 +1,359 @@
+#include "bench_generators.hpp"
+#include "closure_cache.hpp"
+#include "closure_engine.hpp"
+#include "fd_algorithm.hpp"
+#include "fd_parser.hpp"
+#include "lossless_decomposition.hpp"
+#include "normal_form.hpp"
+#include "static_schema.hpp"
+#include <benchmark/benchmark.h>
+#include <sstream>
+
+// Scaling curves of the FieldSet API on synthetic schemas.
+// Every benchmark sets N to the attribute count (pair count for the key
+// explosion), so --benchmark_format=json gives curves and fitted
+// complexities to compare between revisions.
+
+static RandomFDOptions random_options(benchmark::State& state) {
+    RandomFDOptions options;
+    options.attribute_count = static_cast<int>(state.range(0));
+    options.fd_count = static_cast<int>(state.range(1));
+    options.max_lhs = static_cast<int>(state.range(2));
+    options.lhs_sizes = state.range(3) ? LhsSizes::geometric : LhsSizes::uniform;
+    state.counters["fds"] = options.fd_count;
+    return options;
+}
+
+// Arguments: attribute count, FD count, max LHS size, geometric LHS sizes.
+// One curve over the attribute count, then the other parameters varied
+// around 64 attributes.
+static void random_args(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"attributes", "fds", "max_lhs", "geometric"});
+    for (int n = 8; n <= 128; n *= 2) {
+        b->Args({n, n, 3, 0});
+    }
+    for (int fds: {64, 256}) {
+        for (int max_lhs: {2, 5}) {
+            for (int geometric: {0, 1}) {
+                b->Args({64, fds, max_lhs, geometric});
+            }
+        }
+    }
+}
+
+static void BM_closure_of_chain(benchmark::State& state) {
+    auto problem = chain_fds(static_cast<int>(state.range(0)));
+    auto start = make_set(problem.fields[0]);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(closure_of(start, problem.fds));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_closure_of_chain)->RangeMultiplier(2)->Range(8, 512)->Complexity();
+
+static void BM_closure_of_star(benchmark::State& state) {
+    auto problem = star_fds(static_cast<int>(state.range(0)));
+    auto start = make_set(problem.fields[0]);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(closure_of(start, problem.fds));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_closure_of_star)->RangeMultiplier(2)->Range(8, 512)->Complexity();
+
+static void BM_closure_of_random(benchmark::State& state) {
+    auto problem = random_fds(random_options(state));
+    FieldSet start{problem.fields.begin(), problem.fields.begin() + 3};
+    for (auto _: state) {
+        benchmark::DoNotOptimize(closure_of(start, problem.fds));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_closure_of_random)->Apply(random_args);
+
+// 1024 closure queries of 3 attributes per iteration against one engine
+static void BM_closure_batch_random(benchmark::State& state) {
+    auto problem = random_fds(random_options(state));
+    ClosureEngine engine{problem.fds};
+    std::vector<AttributeSet> queries;
+    std::uint32_t seed = 7;
+    for (int i = 0; i < 1024; i++) {
+        AttributeSet query = engine.schema().empty_set();
+        for (int k = 0; k < 3 && engine.schema().size() > 0; k++) {
+            seed = seed * 1103515245 + 12345;
+            query.insert(static_cast<int>((seed >> 8) % engine.schema().size()));
+        }
+        queries.push_back(query);
+    }
+    std::vector<AttributeSet> results(queries.size());
+    for (auto _: state) {
+        engine.closure_batch(queries.data(), queries.size(), results.data());
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_closure_batch_random)->Apply(random_args);
+
+static void BM_candidate_key_chain(benchmark::State& state) {
+    auto problem = chain_fds(static_cast<int>(state.range(0)));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(candidate_key(problem.U, problem.fds));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_candidate_key_chain)->RangeMultiplier(2)->Range(8, 256)->Complexity();
+
+static void BM_candidate_key_random(benchmark::State& state) {
+    auto problem = random_fds(random_options(state));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(candidate_key(problem.U, problem.fds));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_candidate_key_random)->Apply(random_args);
+
+static void BM_all_candidate_keys_explosion(benchmark::State& state) {
+    auto problem = key_explosion_fds(static_cast<int>(state.range(0)));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(all_candidate_keys(problem.U, problem.fds));
+    }
+    state.counters["keys"] = static_cast<double>(1 << state.range(0));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_all_candidate_keys_explosion)->DenseRange(2, 10, 2);
+
+// Compiled mode with and without a ClosureCache, a fresh one per run
+static void BM_all_candidate_keys_explosion_compiled(benchmark::State& state) {
+    auto problem = key_explosion_fds(static_cast<int>(state.range(0)));
+    Schema schema{problem.U};
+    auto U = schema.all();
+    auto fds = schema.encode(problem.fds);
+    auto on_key = [](const AttributeSet&) {
+        return true;
+    };
+    double hit_rate = 0;
+    for (auto _: state) {
+        if (state.range(1)) {
+            ClosureCache cache;
+            all_candidate_keys(U, fds, on_key, cache);
+            hit_rate = static_cast<double>(cache.hits()) / (cache.hits() + cache.misses());
+        }
+        else {
+            all_candidate_keys(U, fds, on_key);
+        }
+    }
+    state.counters["hit_rate"] = hit_rate;
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_all_candidate_keys_explosion_compiled)
+    ->ArgNames({"pairs", "cached"})->ArgsProduct({{4, 8, 10}, {0, 1}});
+
+static void BM_transversal_candidate_keys_explosion(benchmark::State& state) {
+    auto problem = key_explosion_fds(static_cast<int>(state.range(0)));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(transversal_candidate_keys(problem.U, problem.fds));
+    }
+    state.counters["keys"] = static_cast<double>(1 << state.range(0));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_transversal_candidate_keys_explosion)->DenseRange(2, 10, 2);
+
+// First keys of large random schemas, Lucchesi-Osborn against transversals
+static void BM_candidate_keys_capped(benchmark::State& state) {
+    RandomFDOptions options;
+    options.attribute_count = static_cast<int>(state.range(0));
+    options.fd_count = options.attribute_count;
+    options.max_lhs = 2;
+    auto problem = random_fds(options);
+    Schema schema{problem.U};
+    auto U = schema.all();
+    auto fds = schema.encode(problem.fds);
+    const size_t max_keys = 100;
+    for (auto _: state) {
+        if (state.range(1)) {
+            benchmark::DoNotOptimize(transversal_candidate_keys(U, fds, max_keys));
+        }
+        else {
+            size_t count = 0;
+            all_candidate_keys(U, fds, [&count, max_keys](const AttributeSet&) {
+                return ++count < max_keys;
+            });
+        }
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_candidate_keys_capped)
+    ->ArgNames({"attributes", "transversals"})->ArgsProduct({{256, 1024, 4096}, {0, 1}});
+
+static void BM_minimal_cover_chain(benchmark::State& state) {
+    auto problem = chain_fds(static_cast<int>(state.range(0)));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(minimal_cover(problem.fds));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_minimal_cover_chain)->RangeMultiplier(2)->Range(8, 128)->Complexity();
+
+static void BM_minimal_cover_random(benchmark::State& state) {
+    auto problem = random_fds(random_options(state));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(minimal_cover(problem.fds));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_minimal_cover_random)->Apply(random_args);
+
+static void BM_minimal_cover_compiled_random(benchmark::State& state) {
+    auto problem = random_fds(random_options(state));
+    for (auto _: state) {
+        Schema schema{problem.U};
+        benchmark::DoNotOptimize(schema.decode(minimal_cover(schema.encode(problem.fds))));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_minimal_cover_compiled_random)->Apply(random_args);
+
+static void BM_minimal_cover_cached_random(benchmark::State& state) {
+    auto problem = random_fds(random_options(state));
+    double hit_rate = 0;
+    for (auto _: state) {
+        Schema schema{problem.U};
+        ClosureCache cache;
+        benchmark::DoNotOptimize(schema.decode(minimal_cover(schema.encode(problem.fds), cache)));
+        hit_rate = static_cast<double>(cache.hits()) / (cache.hits() + cache.misses());
+    }
+    state.counters["hit_rate"] = hit_rate;
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_minimal_cover_cached_random)->Apply(random_args);
+
+static void BM_minimum_cover_random(benchmark::State& state) {
+    auto problem = random_fds(random_options(state));
+    size_t fds = 0;
+    for (auto _: state) {
+        Schema schema{problem.U};
+        auto cover = minimum_cover(schema.encode(problem.fds));
+        fds = cover.size();
+        benchmark::DoNotOptimize(schema.decode(cover));
+    }
+    state.counters["fds"] = fds;
+    state.counters["minimal_cover_fds"] = minimal_cover(problem.fds).size();
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_minimum_cover_random)->Apply(random_args);
+
+// Cover equivalence, one side reduced and the other as given
+static void BM_equivalent_random(benchmark::State& state) {
+    auto problem = random_fds(random_options(state));
+    auto cover = minimal_cover(problem.fds);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(equivalent(problem.fds, cover));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_equivalent_random)->Apply(random_args);
+
+// Parsing the text of fds with multi-character names, N is the FD count
+static void BM_parse_fds(benchmark::State& state) {
+    RandomFDOptions options;
+    options.attribute_count = 256;
+    options.fd_count = static_cast<int>(state.range(0));
+    options.max_lhs = 4;
+    auto problem = random_fds(options);
+    Schema schema{problem.U};
+    std::ostringstream out;
+    write_fds(out, schema, schema.encode(problem.fds));
+    auto text = out.str();
+
+    for (auto _: state) {
+        Schema parsed;
+        benchmark::DoNotOptimize(parse_fds(text, parsed));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_parse_fds)->RangeMultiplier(8)->Range(64, 1 << 15)->Complexity();
+
+// A fixed 16-attribute chain on StaticSchema against the ClosureEngine
+using Static16 = StaticSchema<16>;
+
+template <std::size_t ... I>
+constexpr auto static_chain(std::index_sequence<I ...>) {
+    return Static16::fds(Static16::fd(Static16::set(I), Static16::set(I + 1)) ...);
+}
+
+constexpr auto static_chain_fds = static_chain(std::make_index_sequence<15>{});
+
+static void BM_static_closure_chain(benchmark::State& state) {
+    Static16::Set set = Static16::set(8);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(set);
+        benchmark::DoNotOptimize(Static16::closure(set, static_chain_fds));
+    }
+}
+BENCHMARK(BM_static_closure_chain);
+
+static void BM_engine_closure_chain(benchmark::State& state) {
+    auto problem = chain_fds(16);
+    Schema schema{problem.U};
+    ClosureEngine engine{schema.encode(problem.fds)};
+    auto set = schema.empty_set();
+    set.insert(8);
+    AttributeSet closure;
+    for (auto _: state) {
+        engine.closure(set, closure);
+        benchmark::DoNotOptimize(closure);
+    }
+}
+BENCHMARK(BM_engine_closure_chain);
+
+static void BM_static_lossless_chain(benchmark::State& state) {
+    auto R1 = Static16::set(0, 1, 2, 3, 4, 5, 6, 7, 8);
+    auto R2 = Static16::set(8, 9, 10, 11, 12, 13, 14, 15);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(R1);
+        benchmark::DoNotOptimize(Static16::is_lossless_decomposition(static_chain_fds, R1, R2));
+    }
+}
+BENCHMARK(BM_static_lossless_chain);
+
+static void BM_is_lossless_decomposition_chain(benchmark::State& state) {
+    auto problem = chain_fds(static_cast<int>(state.range(0)));
+    auto relations = chain_relations(problem);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(is_lossless_decomposition(problem.U, problem.fds, relations));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_is_lossless_decomposition_chain)->RangeMultiplier(2)->Range(8, 256)->Complexity();
+
+static void BM_is_lossless_decomposition_random(benchmark::State& state) {
+    auto problem = random_fds(random_options(state));
+    auto relations = convert_3nf(problem.U, problem.fds);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(is_lossless_decomposition(problem.U, problem.fds, relations));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_is_lossless_decomposition_random)->Apply(random_args);
+
+static void BM_convert_3nf_star(benchmark::State& state) {
+    auto problem = star_fds(static_cast<int>(state.range(0)));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(convert_3nf(problem.U, problem.fds));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_convert_3nf_star)->RangeMultiplier(2)->Range(8, 128)->Complexity();
+
+static void BM_convert_3nf_random(benchmark::State& state) {
+    auto problem = random_fds(random_options(state));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(convert_3nf(problem.U, problem.fds));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_convert_3nf_random)->Apply(random_args);
+
+BENCHMARK_MAIN();
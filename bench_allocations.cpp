@@ -0,0 +1,91 @@
+#include "normal_form.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// Counts heap allocations of the test_problem.cpp workload (section 4),
+// scaled up by renaming the schema into many disjoint copies.
+// Field names are column-like, longer than the small string buffer.
+
+static std::size_t allocation_count = 0;
+static std::size_t allocation_bytes = 0;
+
+void *operator new(std::size_t size) {
+    allocation_count++;
+    allocation_bytes += size;
+    if (void *p = std::malloc(size))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+static FieldSet fields_of(const std::string& names, int copy) {
+    FieldSet result;
+    for (char ch: names) {
+        result.insert(Field{"attribute_column_" + std::string{ch} + "_" + std::to_string(copy)});
+    }
+    return result;
+}
+
+static FDSet problem_fds(int copies) {
+    FDSet fds;
+    for (int i = 0; i < copies; i++) {
+        fds.insert(make_FD(fields_of("A", i), fields_of("BCD", i)));
+        fds.insert(make_FD(fields_of("CD", i), fields_of("B", i)));
+        fds.insert(make_FD(fields_of("EF", i), fields_of("GH", i)));
+        fds.insert(make_FD(fields_of("E", i), fields_of("GIJ", i)));
+        fds.insert(make_FD(fields_of("I", i), fields_of("J", i)));
+    }
+    return fds;
+}
+
+template <typename Func>
+static void measure(const char *name, Func&& f) {
+    auto count = allocation_count;
+    auto bytes = allocation_bytes;
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << name << ": " 
+        << allocation_count - count << " allocations, "
+        << allocation_bytes - bytes << " bytes, "
+        << ms.count() << " ms" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    int copies = argc > 1 ? std::atoi(argv[1]) : 10;
+
+    FDSet fds;
+    FieldSet U;
+    measure("build", [&] {
+        fds = problem_fds(copies);
+        U = field_set_from(fds);
+        for (int i = 0; i < copies; i++) {
+            U += fields_of("K", i);
+        }
+    });
+
+    std::cout << copies << " copies, " << U.size() << " fields, " 
+        << fds.size() << " FDs" << std::endl;
+
+    measure("candidate_key", [&] { candidate_key(U, fds); });
+    measure("non_redundant", [&] { non_redundant(fds); });
+
+    FDSet minimal;
+    measure("minimal_cover", [&] { minimal = minimal_cover(fds); });
+    measure("convert_3nf", [&] { convert_3nf(U, minimal); });
+
+    Schema schema{U};
+    auto compiled = schema.encode(fds);
+    measure("minimal_cover (compiled)", [&] { minimal_cover(compiled); });
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "fd_discovery.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+// Runs discover_fds on a generated table with planted FDs:
+// zip -> city, (city, street) -> district, (zip, house) -> parcel,
+// country is constant, the remaining columns are independent noise.
+// Given a max_error, a max_error / 2 fraction of the cities is replaced
+// by random ones and discover_approximate_fds is run with and without
+// sampling.
+//
+// Usage: bench_fd_discovery [rows [noise_columns [threads [max_error]]]]
+//        bench_fd_discovery --csv <path> [threads [max_error]]
+
+static std::uint32_t next_random(std::uint32_t& seed) {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static std::int32_t mix(std::int32_t x, std::int32_t y, std::int32_t domain) {
+    std::uint32_t h = static_cast<std::uint32_t>(x) * 2654435761u ^ static_cast<std::uint32_t>(y) * 40503u;
+    return static_cast<std::int32_t>((h ^ (h >> 15)) % static_cast<std::uint32_t>(domain));
+}
+
+static Dataset generate(int rows, int noise_columns, double dirty) {
+    std::vector<Field> header{"zip", "city", "street", "district", "house", "parcel", "country"};
+    for (int i = 0; i < noise_columns; i++) {
+        header.push_back(Field{"noise_" + std::to_string(i)});
+    }
+
+    Dataset data{header};
+    std::uint32_t seed = 42;
+    std::vector<std::int32_t> row(header.size());
+    for (int r = 0; r < rows; r++) {
+        auto zip = static_cast<std::int32_t>(next_random(seed) % 500);
+        auto street = static_cast<std::int32_t>(next_random(seed) % 200);
+        auto house = static_cast<std::int32_t>(next_random(seed) % 100);
+        auto city = mix(zip, 0, 40);
+        if (next_random(seed) % 1000000 < dirty * 1000000)
+            city = static_cast<std::int32_t>(next_random(seed) % 40);
+        row[0] = zip;
+        row[1] = city;
+        row[2] = street;
+        row[3] = mix(city, street, 1000);
+        row[4] = house;
+        row[5] = mix(zip, house, 1 << 20);
+        row[6] = 0;
+        for (int i = 0; i < noise_columns; i++) {
+            row[7 + i] = static_cast<std::int32_t>(next_random(seed) % (10 + 7 * i));
+        }
+
+        std::vector<std::string> values;
+        for (auto value: row) {
+            values.push_back(std::to_string(value));
+        }
+        data.append_row(values);
+    }
+    return data;
+}
+
+int main(int argc, char **argv) {
+    bool from_csv = argc > 2 && std::string{argv[1]} == "--csv";
+    int rows = !from_csv && argc > 1 ? std::atoi(argv[1]) : 100000;
+    int noise_columns = !from_csv && argc > 2 ? std::atoi(argv[2]) : 3;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 1;
+    double max_error = argc > 4 ? std::atof(argv[4]) : 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    auto data = from_csv ? load_csv(argv[2]) : generate(rows, noise_columns, max_error / 2);
+    auto loaded = std::chrono::steady_clock::now();
+    ThreadPool pool{threads};
+    auto fds = discover_fds(data, pool);
+    auto end = std::chrono::steady_clock::now();
+
+    using std::chrono::milliseconds;
+    using std::chrono::duration_cast;
+    std::cout << data.row_count() << " rows, " << data.column_count() << " columns, " 
+        << pool.thread_count() << " threads" << std::endl;
+    std::cout << (from_csv ? "load_csv: " : "generate: ") << duration_cast<milliseconds>(loaded - start).count() << " ms" << std::endl;
+    std::cout << "discover_fds: " << duration_cast<milliseconds>(end - loaded).count() << " ms, " 
+        << fds.size() << " FDs" << std::endl;
+
+    if (max_error > 0) {
+        ApproximateFDOptions options;
+        options.max_error = max_error;
+        for (int sample_size: {0, options.sample_size}) {
+            options.sample_size = sample_size;
+            int count = 0;
+            auto approximate_start = std::chrono::steady_clock::now();
+            discover_approximate_fds(data, options, [&](const AttributeFD&, double) { count++; }, pool);
+            auto approximate_end = std::chrono::steady_clock::now();
+            std::cout << "discover_approximate_fds (sample " << sample_size << "): " 
+                << duration_cast<milliseconds>(approximate_end - approximate_start).count() << " ms, " 
+                << count << " FDs" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "bench_generators.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+
+std::vector<Field> attributes(int count) {
+    std::vector<Field> result;
+    for (int i = 0; i < count; i++) {
+        // Zero padded: Field compares names, which then sort like indices
+        auto number = std::to_string(i);
+        result.push_back(Field{"attr_" + std::string(6 - std::min<size_t>(6, number.size()), '0') + number});
+    }
+    return result;
+}
+
+static Problem problem_of(std::vector<Field> fields) {
+    Problem result;
+    result.U = FieldSet(fields.begin(), fields.end());
+    result.fields = std::move(fields);
+    return result;
+}
+
+Problem random_fds(const RandomFDOptions& options) {
+    auto result = problem_of(attributes(options.attribute_count));
+    std::mt19937 random{options.seed};
+    std::uniform_int_distribution<int> uniform_lhs{options.min_lhs, options.max_lhs};
+    std::bernoulli_distribution extra{0.5};
+
+    std::vector<Field> shuffled = result.fields;
+    for (int i = 0; i < options.fd_count; i++) {
+        int lhs_size = options.min_lhs;
+        if (options.lhs_sizes == LhsSizes::uniform) {
+            lhs_size = uniform_lhs(random);
+        }
+        else {
+            while (lhs_size < options.max_lhs && extra(random)) {
+                lhs_size++;
+            }
+        }
+        lhs_size = std::min(lhs_size, options.attribute_count - options.rhs_size);
+
+        // The first lhs_size + rhs_size of a partial shuffle are distinct
+        int needed = lhs_size + options.rhs_size;
+        for (int k = 0; k < needed; k++) {
+            std::uniform_int_distribution<int> pick{k, options.attribute_count - 1};
+            std::swap(shuffled[k], shuffled[pick(random)]);
+        }
+        FieldSet lhs{shuffled.begin(), shuffled.begin() + lhs_size};
+        FieldSet rhs{shuffled.begin() + lhs_size, shuffled.begin() + needed};
+        result.fds.insert(make_FD(lhs, rhs));
+    }
+    return result;
+}
+
+Problem chain_fds(int attribute_count) {
+    auto result = problem_of(attributes(attribute_count));
+    for (int i = 0; i + 1 < attribute_count; i++) {
+        result.fds.insert(make_FD(result.fields[i], result.fields[i + 1]));
+    }
+    return result;
+}
+
+Problem star_fds(int attribute_count) {
+    auto result = problem_of(attributes(attribute_count));
+    for (int i = 1; i < attribute_count; i++) {
+        result.fds.insert(make_FD(result.fields[0], result.fields[i]));
+    }
+    return result;
+}
+
+Problem key_explosion_fds(int pair_count) {
+    auto result = problem_of(attributes(2 * pair_count));
+    for (int i = 0; i < pair_count; i++) {
+        auto& a = result.fields[2 * i];
+        auto& b = result.fields[2 * i + 1];
+        result.fds.insert(make_FD(a, b));
+        result.fds.insert(make_FD(b, a));
+    }
+    return result;
+}
+
+std::vector<FieldSet> chain_relations(const Problem& problem) {
+    std::vector<FieldSet> result;
+    for (std::size_t i = 0; i + 1 < problem.fields.size(); i++) {
+        result.push_back(make_set(problem.fields[i], problem.fields[i + 1]));
+    }
+    return result;
+}
@@ -0,0 +1,54 @@
+#ifndef DB_BENCH_GENERATORS_HPP
+#define DB_BENCH_GENERATORS_HPP
+
+#include "util.hpp"
+#include <vector>
+
+// Synthetic schemas for benchmarks. Attribute i is named "attr_<i>"
+// with i zero padded to six digits, so fields, which are ordered by name,
+// sort in index order.
+
+struct Problem {
+    FieldSet U;
+    FDSet fds;
+    // Attributes in index order
+    std::vector<Field> fields;
+};
+
+enum class LhsSizes {
+    // Uniform in [min_lhs, max_lhs]
+    uniform,
+    // min_lhs plus a geometric number of extra attributes with p = 1/2,
+    // capped at max_lhs: most LHS are small, a few are wide
+    geometric,
+};
+
+struct RandomFDOptions {
+    int attribute_count = 20;
+    int fd_count = 20;
+    int min_lhs = 1;
+    int max_lhs = 3;
+    LhsSizes lhs_sizes = LhsSizes::uniform;
+    int rhs_size = 1;
+    unsigned seed = 1;
+};
+
+std::vector<Field> attributes(int count);
+
+// FDs with distinct random attributes on each side
+Problem random_fds(const RandomFDOptions& options);
+
+// attr_0 -> attr_1 -> ... -> attr_<n-1>
+Problem chain_fds(int attribute_count);
+
+// attr_0 -> attr_i for every other attribute: one wide fan-out
+Problem star_fds(int attribute_count);
+
+// pair_count pairs a_i <-> b_i: every choice of one side per pair is a
+// key, 2^pair_count candidate keys in all
+Problem key_explosion_fds(int pair_count);
+
+// Relations {attr_i, attr_{i+1}} of a chain, a lossless decomposition
+std::vector<FieldSet> chain_relations(const Problem& problem);
+
+#endif
@@ -0,0 +1,95 @@
+#include "closure_cache.hpp"
+
+constexpr int ClosureCache::shard_count;
+
+ClosureCache::ClosureCache(std::size_t capacity)
+    : shard_capacity_{std::max<std::size_t>(1, (capacity + shard_count - 1) / shard_count)} {}
+
+// The unordered_map buckets use the low bits of the hash, the shards
+// take the high ones.
+ClosureCache::Shard& ClosureCache::shard_of(std::size_t hash) {
+    std::uint64_t mixed = static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ULL;
+    return shards_[mixed >> 60];
+}
+
+bool ClosureCache::find_exact(const AttributeSet& set, std::size_t hash, AttributeSet& closure) {
+    auto& shard = shard_of(hash);
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    auto it = shard.entries.find(set);
+    if (it == shard.entries.end())
+        return false;
+
+    shard.uses.splice(shard.uses.begin(), shard.uses, it->second.use);
+    closure = it->second.closure;
+    return true;
+}
+
+void ClosureCache::insert(const AttributeSet& set, std::size_t hash, const AttributeSet& closure) {
+    auto& shard = shard_of(hash);
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    auto inserted = shard.entries.emplace(set, Entry{closure, shard.uses.end()});
+    auto& entry = inserted.first->second;
+    if (!inserted.second) {
+        shard.uses.splice(shard.uses.begin(), shard.uses, entry.use);
+        return;
+    }
+
+    shard.uses.push_front(&inserted.first->first);
+    entry.use = shard.uses.begin();
+    if (shard.entries.size() > shard_capacity_) {
+        shard.entries.erase(*shard.uses.back());
+        shard.uses.pop_back();
+    }
+}
+
+bool ClosureCache::find(const AttributeSet& set, AttributeSet& closure) {
+    std::size_t hash = set.hash();
+    if (find_exact(set, hash, closure)) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    AttributeSet subset = set;
+    for (int id = set.next(0); id >= 0; id = set.next(id + 1)) {
+        subset.erase(id);
+        if (find_exact(subset, subset.hash(), closure) && closure.contains(id)) {
+            insert(set, hash, closure);
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        subset.insert(id);
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void ClosureCache::insert(const AttributeSet& set, const AttributeSet& closure) {
+    insert(set, set.hash(), closure);
+}
+
+void ClosureCache::closure(ClosureEngine& engine, const AttributeSet& set, AttributeSet& result) {
+    if (find(set, result))
+        return;
+    engine.closure(set, result);
+    insert(set, result);
+}
+
+std::size_t ClosureCache::size() {
+    std::size_t result = 0;
+    for (auto& shard: shards_) {
+        std::lock_guard<std::mutex> lock{shard.mutex};
+        result += shard.entries.size();
+    }
+    return result;
+}
+
+void ClosureCache::clear() {
+    for (auto& shard: shards_) {
+        std::lock_guard<std::mutex> lock{shard.mutex};
+        shard.entries.clear();
+        shard.uses.clear();
+    }
+    hits_.store(0, std::memory_order_relaxed);
+    misses_.store(0, std::memory_order_relaxed);
+}
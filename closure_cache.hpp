@@ -0,0 +1,88 @@
+#ifndef DB_CLOSURE_CACHE_HPP
+#define DB_CLOSURE_CACHE_HPP
+
+#include "attribute_set.hpp"
+#include "closure_engine.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+// Bounded memo of attribute closures under one FD set, shared by threads.
+// Entries are spread over shards by the hash of the set, each shard with
+// its own lock and least recently used eviction.
+// Closures are monotone: when Y is a subset of X and X is in the closure
+// of Y, X has the same closure as Y. A set missing from the cache is
+// answered from a cached set one attribute smaller when that holds.
+// The cache does not know the FDs: every engine and closure passed to it
+// must come from the same FD set, or an equivalent one.
+class ClosureCache {
+private:
+    static constexpr int shard_count = 16;
+
+    struct Entry {
+        AttributeSet closure;
+        std::list<const AttributeSet *>::iterator use;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<AttributeSet, Entry> entries;
+        // Keys of entries, most recently used first
+        std::list<const AttributeSet *> uses;
+    };
+
+    Shard shards_[shard_count];
+    std::size_t shard_capacity_;
+
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+
+    Shard& shard_of(std::size_t hash);
+
+    bool find_exact(const AttributeSet& set, std::size_t hash, AttributeSet& closure);
+
+    void insert(const AttributeSet& set, std::size_t hash, const AttributeSet& closure);
+
+public:
+    // Holds at most about capacity closures
+    explicit ClosureCache(std::size_t capacity = 1 << 16);
+
+    ClosureCache(const ClosureCache&) = delete;
+
+    ClosureCache& operator = (const ClosureCache&) = delete;
+
+    // Looks up set, then its subsets one attribute smaller.
+    // Counts a hit or a miss.
+    bool find(const AttributeSet& set, AttributeSet& closure);
+
+    void insert(const AttributeSet& set, const AttributeSet& closure);
+
+    // result = closure of set, computed by engine and stored on a miss.
+    // Engines are not thread-safe: threads sharing the cache each pass
+    // their own.
+    void closure(ClosureEngine& engine, const AttributeSet& set, AttributeSet& result);
+
+    AttributeSet closure(ClosureEngine& engine, const AttributeSet& set) {
+        AttributeSet result;
+        closure(engine, set, result);
+        return result;
+    }
+
+    std::uint64_t hits() const {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t misses() const {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t size();
+
+    // Drops the entries and zeroes the counters
+    void clear();
+};
+
+#endif
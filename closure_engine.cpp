@@ -0,0 +1,179 @@
+#include "closure_engine.hpp"
+#include "instrumentation.hpp"
+
+ClosureEngine::ClosureEngine(const AttributeFDSet& fds) {
+    fd_count_ = static_cast<int>(fds.size());
+    universe_size_ = fds.empty() ? 0 : fds.front().first.universe_size();
+
+    lhs_.reserve(fd_count_);
+    lhs_size_.resize(fd_count_);
+    rhs_offsets_.push_back(0);
+    std::vector<int> index_count(universe_size_, 0);
+
+    for (int i = 0; i < fd_count_; i++) {
+        auto& fd = fds[i];
+        lhs_.push_back(fd.first);
+        lhs_size_[i] = fd.first.size();
+        fd.first.for_each([&index_count](int id) {
+            index_count[id]++;
+        });
+        fd.second.for_each([this](int id) {
+            rhs_ids_.push_back(id);
+        });
+        rhs_offsets_.push_back(static_cast<int>(rhs_ids_.size()));
+    }
+
+    index_offsets_.resize(universe_size_ + 1, 0);
+    for (int id = 0; id < universe_size_; id++) {
+        index_offsets_[id + 1] = index_offsets_[id] + index_count[id];
+    }
+
+    index_fds_.resize(index_offsets_[universe_size_]);
+    index_ends_.assign(index_offsets_.begin(), index_offsets_.end() - 1);
+    for (int i = 0; i < fd_count_; i++) {
+        fds[i].first.for_each([this, i](int id) {
+            index_fds_[index_ends_[id]++] = i;
+        });
+    }
+
+    enabled_.resize(fd_count_, 1);
+    scratch_ = make_scratch();
+}
+
+ClosureEngine::ClosureEngine(Schema schema, const FDSet& fds)
+    : ClosureEngine{schema.encode(fds)} {
+    schema_ = std::move(schema);
+}
+
+ClosureEngine::ClosureEngine(const FDSet& fds)
+    : ClosureEngine{Schema{field_set_from(fds)}, fds} {}
+
+ClosureEngine::Scratch ClosureEngine::make_scratch() const {
+    Scratch result;
+    result.counters = lhs_size_;
+    // One slot past the universe for the unconditional write
+    result.queue.resize(universe_size_ + 1);
+    result.fired.resize(fd_count_);
+    return result;
+}
+
+// Which FDs fire and which attributes are new is data dependent and
+// mispredicts badly, so both are recorded without branches: the index is
+// written unconditionally and the list end only advances when it counts.
+void ClosureEngine::closure(const AttributeSet& set, AttributeSet& result, Scratch& scratch) const {
+    DB_COUNT(closure_calls, 1);
+    result = set;
+    if (fd_count_ == 0)
+        return;
+
+    auto& counters = scratch.counters;
+    int *queue = scratch.queue.data();
+    int *fired = scratch.fired.data();
+    int tail = 0;
+    set.for_each([queue, &tail](int id) {
+        queue[tail++] = id;
+    });
+
+    int touched = 0;
+    for (int head = 0; head < tail; head++) {
+        int id = queue[head];
+        int fired_count = 0;
+        touched += index_ends_[id] - index_offsets_[id];
+        for (int k = index_offsets_[id]; k < index_ends_[id]; k++) {
+            int fd = index_fds_[k];
+            fired[fired_count] = fd;
+            fired_count += (--counters[fd] == 0) & enabled_[fd];
+        }
+
+        for (int f = 0; f < fired_count; f++) {
+            int fd = fired[f];
+            for (int r = rhs_offsets_[fd]; r < rhs_offsets_[fd + 1]; r++) {
+                int rhs_id = rhs_ids_[r];
+                bool fresh = !result.contains(rhs_id);
+                result.insert(rhs_id);
+                queue[tail] = rhs_id;
+                tail += fresh;
+            }
+        }
+    }
+
+    DB_COUNT(fds_scanned, touched);
+
+    // Every decremented counter is on the index list of a queued attribute,
+    // a plain copy is cheaper once most of them were
+    if (touched > fd_count_) {
+        std::copy(lhs_size_.begin(), lhs_size_.end(), counters.begin());
+        return;
+    }
+    for (int head = 0; head < tail; head++) {
+        int id = queue[head];
+        for (int k = index_offsets_[id]; k < index_ends_[id]; k++) {
+            counters[index_fds_[k]] = lhs_size_[index_fds_[k]];
+        }
+    }
+}
+
+FieldSet ClosureEngine::closure(const FieldSet& set) {
+    FieldSet result;
+    AttributeSet encoded = schema_.empty_set();
+    for (auto& field: set) {
+        int id = schema_.id_of(field);
+        if (id == -1)
+            result.insert(field);
+        else
+            encoded.insert(id);
+    }
+    return result + schema_.decode(closure(encoded));
+}
+
+void ClosureEngine::closure_batch(const AttributeSet *sets, std::size_t count, AttributeSet *results) {
+    for (std::size_t i = 0; i < count; i++) {
+        closure(sets[i], results[i]);
+    }
+}
+
+void ClosureEngine::closure_batch(const AttributeSet *sets, std::size_t count, AttributeSet *results,
+        ThreadPool& pool) const {
+    std::vector<Scratch> scratches;
+    for (int i = 0; i < pool.thread_count(); i++) {
+        scratches.push_back(make_scratch());
+    }
+    pool.parallel_for(static_cast<int>(count), [&](int i, int worker) {
+        closure(sets[i], results[i], scratches[worker]);
+    });
+}
+
+std::vector<AttributeSet> ClosureEngine::closure_batch(const std::vector<AttributeSet>& sets) {
+    std::vector<AttributeSet> results(sets.size());
+    closure_batch(sets.data(), sets.size(), results.data());
+    return results;
+}
+
+std::vector<FieldSet> ClosureEngine::closure_batch(const std::vector<FieldSet>& sets) {
+    std::vector<FieldSet> results;
+    results.reserve(sets.size());
+    for (auto& set: sets) {
+        results.push_back(closure(set));
+    }
+    return results;
+}
+
+void ClosureEngine::shrink_lhs(int fd_index, const AttributeSet& lhs) {
+    lhs_[fd_index].for_each([this, fd_index, &lhs](int id) {
+        if (lhs.contains(id))
+            return;
+
+        int end = index_ends_[id];
+        for (int k = index_offsets_[id]; k < end; k++) {
+            if (index_fds_[k] == fd_index) {
+                index_fds_[k] = index_fds_[end - 1];
+                index_ends_[id]--;
+                break;
+            }
+        }
+    });
+
+    lhs_[fd_index] = lhs;
+    lhs_size_[fd_index] = lhs.size();
+    scratch_.counters[fd_index] = lhs_size_[fd_index];
+}
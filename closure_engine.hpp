@@ -0,0 +1,111 @@
+#ifndef DB_CLOSURE_ENGINE_HPP
+#define DB_CLOSURE_ENGINE_HPP
+
+#include "attribute_set.hpp"
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <vector>
+
+// Linear-time attribute closure (LINCLOSURE).
+// The FD set is compiled once into an attribute -> FD index. Each closure
+// keeps a counter of the unsatisfied LHS attributes of every FD, so it runs
+// in O(total size of the FD set). Only the counters a closure touched are
+// reset afterwards, so small closures stay cheap against large FD sets.
+// Like closure_of, FDs with an empty LHS are ignored.
+// Holds scratch buffers: one engine must not be used by several threads,
+// except through the ThreadPool form of closure_batch.
+// Once built, closure(set, result), set_enabled and shrink_lhs do not
+// allocate when result already has the size of the universe.
+class ClosureEngine {
+private:
+    struct Scratch {
+        std::vector<int> counters;
+        std::vector<int> queue;
+        std::vector<int> fired;
+    };
+
+    int universe_size_ = 0;
+    int fd_count_ = 0;
+
+    std::vector<AttributeSet> lhs_;
+    std::vector<int> lhs_size_;
+    std::vector<int> rhs_offsets_;
+    std::vector<int> rhs_ids_;
+    std::vector<int> index_offsets_;
+    std::vector<int> index_ends_;
+    std::vector<int> index_fds_;
+    std::vector<char> enabled_;
+
+    // Only set when built from a FDSet
+    Schema schema_;
+
+    Scratch scratch_;
+
+    Scratch make_scratch() const;
+
+    void closure(const AttributeSet& set, AttributeSet& result, Scratch& scratch) const;
+
+    ClosureEngine(Schema schema, const FDSet& fds);
+
+public:
+    explicit ClosureEngine(const AttributeFDSet& fds);
+
+    // Encodes fds with a Schema of the fields they use, see schema()
+    explicit ClosureEngine(const FDSet& fds);
+
+    int universe_size() const {
+        return universe_size_;
+    }
+
+    int fd_count() const {
+        return fd_count_;
+    }
+
+    // A disabled FD is skipped by closure(), as if it was removed
+    void set_enabled(int fd_index, bool enabled) {
+        enabled_[fd_index] = enabled;
+    }
+
+    bool enabled(int fd_index) const {
+        return enabled_[fd_index];
+    }
+
+    const AttributeSet& lhs(int fd_index) const {
+        return lhs_[fd_index];
+    }
+
+    // Replaces the LHS of an FD by a subset of it
+    void shrink_lhs(int fd_index, const AttributeSet& lhs);
+
+    const Schema& schema() const {
+        return schema_;
+    }
+
+    void closure(const AttributeSet& set, AttributeSet& result) {
+        closure(set, result, scratch_);
+    }
+
+    AttributeSet closure(const AttributeSet& set) {
+        AttributeSet result;
+        closure(set, result);
+        return result;
+    }
+
+    // Same as closure_of(set, fds) for an engine built from fds.
+    // Fields that no FD uses are kept as they are.
+    FieldSet closure(const FieldSet& set);
+
+    // results[i] = closure(sets[i]) for i < count, the engine tables
+    // staying in cache across the batch
+    void closure_batch(const AttributeSet *sets, std::size_t count, AttributeSet *results);
+
+    // Same, spread over pool with a scratch per worker
+    void closure_batch(const AttributeSet *sets, std::size_t count, AttributeSet *results,
+            ThreadPool& pool) const;
+
+    std::vector<AttributeSet> closure_batch(const std::vector<AttributeSet>& sets);
+
+    std::vector<FieldSet> closure_batch(const std::vector<FieldSet>& sets);
+};
+
+#endif
@@ -0,0 +1,262 @@
+#include "dataset.hpp"
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+namespace detail {
+
+// Eight bytes per multiply, values are mostly short
+static std::size_t hash_bytes(const char *data, std::size_t size) {
+    const std::uint64_t k = 0x9e3779b97f4a7c15ull;
+    std::uint64_t h = size * k;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ word) * k;
+        h ^= h >> 32;
+    }
+    std::uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    h = (h ^ tail) * k;
+    return static_cast<std::size_t>(h ^ (h >> 29));
+}
+
+void Dictionary::grow() {
+    slots_.assign(std::max<std::size_t>(16, slots_.size() * 2), Slot{-1, 0});
+    std::size_t mask = slots_.size() - 1;
+    for (std::int32_t code = 0; code < size(); code++) {
+        std::size_t hash = hash_bytes(values_[code].data(), values_[code].size());
+        std::size_t i = hash & mask;
+        while (slots_[i].code != -1) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = Slot{code, static_cast<std::uint32_t>(hash >> 32)};
+    }
+}
+
+std::int32_t Dictionary::encode(const char *data, std::size_t size) {
+    if (2 * (values_.size() + 1) > slots_.size())
+        grow();
+
+    std::size_t hash = hash_bytes(data, size);
+    auto tag = static_cast<std::uint32_t>(hash >> 32);
+    std::size_t mask = slots_.size() - 1;
+    std::size_t i = hash & mask;
+    for (; slots_[i].code != -1; i = (i + 1) & mask) {
+        if (slots_[i].tag != tag)
+            continue;
+        auto& value = values_[slots_[i].code];
+        if (value.size() == size && std::memcmp(value.data(), data, size) == 0)
+            return slots_[i].code;
+    }
+
+    auto code = static_cast<std::int32_t>(values_.size());
+    values_.emplace_back(data, size);
+    slots_[i] = Slot{code, tag};
+    return code;
+}
+
+namespace {
+
+struct FieldView {
+    const char *data;
+    std::size_t size;
+};
+
+// Splits complete rows into fields that point into the input.
+// Quoted fields with "" inside are unescaped into per-field scratch,
+// a deque so that growing it keeps the views of the row's earlier fields.
+class CsvParser {
+private:
+    Dataset& dataset_;
+    bool has_header_ = false;
+    std::vector<FieldView> fields_;
+    std::deque<std::string> unescaped_;
+    std::vector<std::int32_t> codes_;
+
+    void end_row() {
+        if (fields_.size() == 1 && fields_[0].size == 0)
+            return;
+
+        if (!has_header_) {
+            std::vector<Field> header;
+            for (auto& field: fields_) {
+                header.push_back(Field{std::string{field.data, field.size}});
+            }
+            dataset_ = Dataset{std::move(header)};
+            codes_.resize(dataset_.column_count());
+            has_header_ = true;
+            return;
+        }
+
+        for (int c = 0; c < dataset_.column_count(); c++) {
+            codes_[c] = c < static_cast<int>(fields_.size())
+                ? dataset_.encode(c, fields_[c].data, fields_[c].size)
+                : dataset_.encode(c, "", 0);
+        }
+        dataset_.append_codes(codes_);
+    }
+
+public:
+    explicit CsvParser(Dataset& dataset): dataset_(dataset) {}
+
+    // Consumes the complete rows of [begin, end) and returns the start of
+    // the first incomplete one. When last is set, end also ends a row.
+    const char *parse(const char *begin, const char *end, bool last) {
+        const char *row = begin;
+        const char *p = begin;
+        fields_.clear();
+        while (true) {
+            // One field starts at p
+            const char *field_begin = p;
+            const char *field_end;
+            bool quoted = p < end && *p == '"';
+            bool escaped = false;
+            if (quoted) {
+                field_begin = ++p;
+                while (true) {
+                    p = static_cast<const char *>(std::memchr(p, '"', end - p));
+                    if (p == nullptr)
+                        return last ? end : row;
+                    if (p + 1 < end && p[1] == '"') {
+                        escaped = true;
+                        p += 2;
+                        continue;
+                    }
+                    if (p + 1 == end && !last)
+                        return row;
+                    break;
+                }
+                field_end = p++;
+                while (p < end && *p != ',' && *p != '\n') {
+                    p++;
+                }
+            }
+            else {
+                while (p < end && *p != ',' && *p != '\n') {
+                    p++;
+                }
+                field_end = p;
+            }
+            if (p == end && !last)
+                return row;
+
+            if (!quoted && field_end > field_begin && field_end[-1] == '\r' && 
+                    (p == end || *p == '\n'))
+                field_end--;
+
+            if (escaped) {
+                if (unescaped_.size() <= fields_.size())
+                    unescaped_.resize(fields_.size() + 1);
+                auto& scratch = unescaped_[fields_.size()];
+                scratch.clear();
+                for (const char *q = field_begin; q < field_end; q++) {
+                    scratch += *q;
+                    if (*q == '"')
+                        q++;
+                }
+                fields_.push_back(FieldView{scratch.data(), scratch.size()});
+            }
+            else {
+                fields_.push_back(FieldView{field_begin, static_cast<std::size_t>(field_end - field_begin)});
+            }
+
+            if (p < end && *p == ',') {
+                p++;
+                continue;
+            }
+            end_row();
+            fields_.clear();
+            if (p == end)
+                return end;
+            row = ++p;
+            if (p == end && last)
+                return end;
+        }
+    }
+};
+
+} // namespace
+
+} // namespace detail
+
+Dataset::Dataset(std::vector<Field> header)
+    : header_{std::move(header)}, columns_(header_.size()),
+    dictionaries_(header_.size()) {}
+
+void Dataset::append_row(const std::vector<std::string>& values) {
+    for (int c = 0; c < column_count(); c++) {
+        columns_[c].push_back(encode(c, values[c]));
+    }
+    row_count_++;
+}
+
+void Dataset::append_codes(const std::vector<std::int32_t>& codes) {
+    for (int c = 0; c < column_count(); c++) {
+        columns_[c].push_back(codes[c]);
+    }
+    row_count_++;
+}
+
+Schema Dataset::schema() const {
+    Schema result;
+    for (auto& field: header_) {
+        result.add(field);
+    }
+    return result;
+}
+
+Dataset read_csv(std::istream& in) {
+    Dataset result;
+    detail::CsvParser parser{result};
+
+    std::vector<char> buffer(std::size_t{1} << 20);
+    std::size_t size = 0;
+    while (true) {
+        if (size == buffer.size())
+            buffer.resize(buffer.size() * 2);
+        in.read(buffer.data() + size, buffer.size() - size);
+        size += static_cast<std::size_t>(in.gcount());
+        bool last = !in;
+
+        const char *begin = buffer.data();
+        const char *stop = parser.parse(begin, begin + size, last);
+        if (last)
+            break;
+        size -= stop - begin;
+        std::memmove(buffer.data(), stop, size);
+    }
+    return result;
+}
+
+Dataset load_csv(const std::string& path, std::size_t window_size) {
+    detail::File file{path};
+    auto file_size = file.size();
+    auto page_size = detail::page_size();
+    window_size = std::max(window_size / page_size, std::size_t{1}) * page_size;
+
+    Dataset result;
+    detail::CsvParser parser{result};
+    std::size_t offset = 0;
+    while (offset < file_size) {
+        // Mappings start on a page, rows on any byte
+        std::size_t map_offset = offset / page_size * page_size;
+        std::size_t length = std::min(window_size + (offset - map_offset), file_size - map_offset);
+        bool last = map_offset + length == file_size;
+
+        detail::Mapping mapping{file, map_offset, length};
+        const char *begin = mapping.data() + (offset - map_offset);
+        const char *stop = parser.parse(begin, mapping.data() + length, last);
+        if (stop == begin && !last) {
+            // A row longer than the window
+            window_size *= 2;
+            continue;
+        }
+        offset += stop - begin;
+        if (last)
+            break;
+    }
+    return result;
+}
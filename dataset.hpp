@@ -0,0 +1,110 @@
+#ifndef DB_DATASET_HPP
+#define DB_DATASET_HPP
+
+#include "attribute_set.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace detail {
+
+// Distinct values of a column, numbered in order of first appearance.
+// Lookups hash the bytes in place, only new values are copied.
+class Dictionary {
+private:
+    struct Slot {
+        std::int32_t code;
+        std::uint32_t tag;
+    };
+
+    std::vector<std::string> values_;
+    // Open addressing over codes, code -1 is a free slot.
+    // The tag holds the high hash bits, most mismatches stop there.
+    std::vector<Slot> slots_;
+
+    void grow();
+
+public:
+    std::int32_t encode(const char *data, std::size_t size);
+
+    int size() const {
+        return static_cast<int>(values_.size());
+    }
+
+    const std::string& value(std::int32_t code) const {
+        return values_[code];
+    }
+};
+
+} // namespace detail
+
+// Column-major table: every column is dictionary-encoded into dense
+// int32 codes, in order of first appearance.
+class Dataset {
+private:
+    std::vector<Field> header_;
+    std::vector<std::vector<std::int32_t>> columns_;
+    std::vector<detail::Dictionary> dictionaries_;
+    int row_count_ = 0;
+
+public:
+    Dataset() = default;
+
+    explicit Dataset(std::vector<Field> header);
+
+    int row_count() const {
+        return row_count_;
+    }
+
+    int column_count() const {
+        return static_cast<int>(header_.size());
+    }
+
+    const std::vector<Field>& header() const {
+        return header_;
+    }
+
+    const std::vector<std::int32_t>& column(int c) const {
+        return columns_[c];
+    }
+
+    int distinct_count(int c) const {
+        return dictionaries_[c].size();
+    }
+
+    const std::string& value(int c, std::int32_t code) const {
+        return dictionaries_[c].value(code);
+    }
+
+    std::int32_t encode(int c, const char *data, std::size_t size) {
+        return dictionaries_[c].encode(data, size);
+    }
+
+    std::int32_t encode(int c, const std::string& value) {
+        return encode(c, value.data(), value.size());
+    }
+
+    // values has one entry per column
+    void append_row(const std::vector<std::string>& values);
+
+    // codes has one entry per column, each returned by encode
+    void append_codes(const std::vector<std::int32_t>& codes);
+
+    // Column c gets attribute id c
+    Schema schema() const;
+};
+
+// Comma-separated values, the first row is the header.
+// Fields may be quoted, with "" for a quote inside; quoted fields may
+// span lines. Missing trailing fields are empty, extra ones are ignored.
+Dataset read_csv(std::istream& in);
+
+// Same format, read from a file mapped window_size bytes at a time.
+// Fields are tokenized in the mapping and only distinct values are
+// copied, so the memory beyond the codes and dictionaries is about one
+// window. Throws std::system_error when the file cannot be read.
+Dataset load_csv(const std::string& path, std::size_t window_size = std::size_t{64} << 20);
+
+#endif
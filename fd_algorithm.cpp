@@ -1,64 +1,185 @@
 #include "fd_algorithm.hpp"
+#include "closure_cache.hpp"
+#include "closure_engine.hpp"
+#include "instrumentation.hpp"
+#include "thread_pool.hpp"
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+AttributeClasses<FieldSet> classify_attributes(const FieldSet& U, const FDSet& fds) {
+    FieldSet left, right;
+    for (auto& fd: fds) {
+        if (fd.first.empty())
+            continue;
+        left += fd.first;
+        right += fd.second;
+    }
+
+    AttributeClasses<FieldSet> result;
+    result.LR = U * left * right;
+    result.L = (U * left) - right;
+    result.R = (U * right) - left;
+    result.N = U - left - right;
+    return result;
+}
 
 FieldSet closure_of(const FieldSet& set, const FDSet& fds) {
+    DB_COUNT(closure_calls, 1);
+    DB_COUNT(field_set_allocations, !set.empty());
     FieldSet result = set;
-    FieldSet X, Y;
-    auto pred = [&X, &Y, &result](auto fd) {
-        X = fd.first;
-        Y = fd.second;
-        return X.size() > 0 && is_subset(X, result) && !is_subset(Y, result);
+    auto pred = [&result](const FD& fd) {
+        DB_COUNT(fds_scanned, 1);
+        return fd.first.size() > 0 && is_subset(fd.first, result) && 
+            !is_subset(fd.second, result);
     };
 
-    while (std::any_of(fds.begin(), fds.end(), pred)) {
-        result = result + Y;
+    for (auto it = std::find_if(fds.begin(), fds.end(), pred); it != fds.end(); 
+            it = std::find_if(fds.begin(), fds.end(), pred)) {
+        DB_COUNT(fixpoint_iterations, 1);
+        DB_COUNT(field_set_allocations, 1);
+        result = result + it->second;
     }
     return result;
 }
 
+// R attributes are in no key and L, N attributes in every key,
+// so only LR attributes are tried. Gives the same key as dropping
+// every attribute of U in order.
 FieldSet candidate_key(const FieldSet& U, const FDSet& fds) {
-    FieldSet result = U;
-    for (auto& field: U) {
+    DB_PHASE("candidate_key");
+    auto classes = classify_attributes(U, fds);
+    ClosureEngine engine{fds};
+    FieldSet core = classes.L + classes.N;
+    if (engine.closure(core) == U)
+        return core;
+
+    FieldSet result = U - classes.R;
+    for (auto& field: classes.LR) {
         result.erase(field);
-        if (closure_of(result, fds) != U) {
+        if (engine.closure(result) != U) {
             result.insert(field);
         }
     }
     return result;
 }
 
-bool equivalent_after_remove(const FDSet& fds, const FD& fd) {
-    FDSet removed = fds - make_set(fd);
-    auto Y = closure_of(fd.first, removed);
-    if (is_subset(fd.second, Y)) 
+void all_candidate_keys(const FieldSet& U, const FDSet& fds, 
+        const std::function<bool(const FieldSet&)>& on_key) {
+    Schema schema{U + field_set_from(fds)};
+    all_candidate_keys(schema.encode(U), schema.encode(fds), 
+            [&schema, &on_key](const AttributeSet& key) {
+        return on_key(schema.decode(key));
+    });
+}
+
+std::vector<FieldSet> all_candidate_keys(const FieldSet& U, const FDSet& fds) {
+    std::vector<FieldSet> result;
+    all_candidate_keys(U, fds, [&result](const FieldSet& key) {
+        result.push_back(key);
         return true;
-    else
-        return false;
+    });
+    return result;
 }
 
+namespace {
+
+// Index of fd in the engine built from fds, -1 when it is not there
+int fd_index_of(const FDSet& fds, const FD& fd) {
+    auto it = fds.find(fd);
+    return it == fds.end() ? -1 : static_cast<int>(std::distance(fds.begin(), it));
+}
+
+} // namespace
+
+bool equivalent_after_remove(const FDSet& fds, const FD& fd) {
+    ClosureEngine engine{fds};
+    int index = fd_index_of(fds, fd);
+    if (index != -1)
+        engine.set_enabled(index, false);
+    return is_subset(fd.second, engine.closure(fd.first));
+}
+
+// Builds an engine over a copy of fds with newfd, each closure disabling
+// the FD that is not in its FD set. For a single check: minimal_cover
+// keeps one engine across its reductions instead.
 bool equivalent_after_replace(const FDSet& fds, const FD& oldfd, const FD& newfd) {
-    FDSet newfds = fds;
-    newfds.erase(oldfd);
-    newfds.insert(newfd);
+    FDSet all = fds;
+    all.insert(newfd);
+    ClosureEngine engine{all};
+    int new_index = fd_index_of(all, newfd);
+    int old_index = oldfd == newfd ? -1 : fd_index_of(all, oldfd);
 
-    auto Y1 = closure_of(newfd.first, fds);
-    auto Y2 = closure_of(oldfd.first, newfds); 
-    if (is_subset(newfd.second, Y1) && is_subset(oldfd.second, Y2))
-        return true;
-    else
+    if (!set_contains(fds, newfd))
+        engine.set_enabled(new_index, false);
+    if (!is_subset(newfd.second, engine.closure(newfd.first)))
         return false;
+
+    engine.set_enabled(new_index, true);
+    if (old_index != -1)
+        engine.set_enabled(old_index, false);
+    return is_subset(oldfd.second, engine.closure(oldfd.first));
+}
+
+bool implies(const FDSet& fds, const FD& fd) {
+    return implies_all(fds, make_set(fd));
 }
 
+namespace {
+
+// FDs of other that need a closure to be checked against fds
+FDSet unchecked(const FDSet& fds, const FDSet& other) {
+    FDSet result;
+    for (auto& fd: other) {
+        if (is_subset(fd.second, fd.first))
+            continue;
+        if (fds.count(fd))
+            continue;
+        result.insert(fd);
+    }
+    return result;
+}
+
+} // namespace
+
+bool implies_all(const FDSet& fds, const FDSet& other) {
+    auto checked = unchecked(fds, other);
+    if (checked.empty())
+        return true;
+
+    Schema schema{field_set_from(fds) + field_set_from(checked)};
+    return implies_all(schema.encode(fds), schema.encode(checked));
+}
+
+bool equivalent(const FDSet& fds, const FDSet& other) {
+    auto checked = unchecked(fds, other);
+    auto other_checked = unchecked(other, fds);
+    if (checked.empty() && other_checked.empty())
+        return true;
+
+    Schema schema{field_set_from(fds) + field_set_from(other)};
+    return implies_all(schema.encode(fds), schema.encode(checked)) && 
+        implies_all(schema.encode(other), schema.encode(other_checked));
+}
+
+// One engine over fds, the FDs removed so far staying disabled
 FDSet non_redundant(const FDSet& fds) {
-    FDSet result = fds;
+    ClosureEngine engine{fds};
+    FDSet result;
+    int index = 0;
     for (auto& fd: fds) {
-        if (equivalent_after_remove(result, fd))
-            result.erase(fd);
+        engine.set_enabled(index, false);
+        if (!is_subset(fd.second, engine.closure(fd.first))) {
+            engine.set_enabled(index, true);
+            result.insert(fd);
+        }
+        index++;
     }
     return result;
 }
 
 FDSet minimal_cover(const FDSet& fds) {
+    DB_PHASE("minimal_cover");
     FDSet result;
     // Step 1 
     for (auto& fd: fds) {
@@ -68,23 +189,655 @@ FDSet minimal_cover(const FDSet& fds) {
     }
 
     // Step 2 
-    auto copy = result;
-    for (auto& fd: copy) {
-        auto modified_set = fd.first;
-        for (auto& field: fd.first) {
-            modified_set.erase(field);
-            if (modified_set.size() == 0)
-                break;
+    // One engine over the step 1 FDs, a reduced FD having its LHS shrunk
+    // in place. X - B -> A implies X -> A, so replacing X -> A only needs
+    // A in the closure of X - B.
+    {
+        DB_PHASE("minimal_cover/left_reduce");
+        auto copy = result;
+        ClosureEngine engine{copy};
+        int index = 0;
+        for (auto& fd: copy) {
+            auto modified_set = fd.first;
+            for (auto& field: fd.first) {
+                modified_set.erase(field);
+                if (modified_set.size() == 0)
+                    break;
 
-            if (equivalent_after_replace(result, fd, make_FD(modified_set, fd.second))) {
-                result.erase(fd);
-                result.insert(make_FD(modified_set, fd.second));
-                break;
+                if (is_subset(fd.second, engine.closure(modified_set))) {
+                    engine.shrink_lhs(index, engine.schema().encode(modified_set));
+                    result.erase(fd);
+                    result.insert(make_FD(modified_set, fd.second));
+                    break;
+                }
+                modified_set.insert(field);
             }
-            modified_set.insert(field);
+            index++;
         }
     }
 
     // Step 3
+    DB_PHASE("minimal_cover/non_redundant");
     return non_redundant(result);
 }
+
+// Schema-compiled mode
+AttributeSet closure_of(const AttributeSet& set, const AttributeFDSet& fds) {
+    ClosureEngine engine{fds};
+    return engine.closure(set);
+}
+
+AttributeClasses<AttributeSet> classify_attributes(
+        const AttributeSet& U, const AttributeFDSet& fds) {
+    AttributeSet left(U.universe_size()), right(U.universe_size());
+    for (auto& fd: fds) {
+        if (fd.first.empty())
+            continue;
+        left |= fd.first;
+        right |= fd.second;
+    }
+
+    AttributeClasses<AttributeSet> result;
+    result.LR = U * left * right;
+    result.L = (U * left) - right;
+    result.R = (U * right) - left;
+    result.N = U - left - right;
+    return result;
+}
+
+AttributeSet candidate_key(const AttributeSet& U, const AttributeFDSet& fds) {
+    DB_PHASE("candidate_key");
+    ClosureEngine engine{fds};
+    auto classes = classify_attributes(U, fds);
+    AttributeSet core = classes.L + classes.N;
+    if (engine.closure(core) == U)
+        return core;
+
+    AttributeSet result = U - classes.R;
+    classes.LR.for_each([&result, &U, &engine](int id) {
+        result.erase(id);
+        if (engine.closure(result) != U) {
+            result.insert(id);
+        }
+    });
+    return result;
+}
+
+bool implies(const AttributeFDSet& fds, const AttributeFD& fd) {
+    return is_subset(fd.second, closure_of(fd.first, fds));
+}
+
+bool implies_all(const AttributeFDSet& fds, const AttributeFDSet& other) {
+    if (other.empty())
+        return true;
+
+    // The engine ignores FDs with an empty LHS, as closure_of does, but
+    // they hold for every LHS: each closure starts from their RHS
+    AttributeSet constants;
+    for (auto& fd: fds) {
+        if (!fd.first.empty())
+            continue;
+        if (constants.universe_size() == 0)
+            constants = fd.second;
+        else
+            constants |= fd.second;
+    }
+
+    ClosureEngine engine{fds};
+    AttributeSet start;
+    AttributeSet closure;
+    for (auto& fd: other) {
+        if (is_subset(fd.second, fd.first))
+            continue;
+        start = fd.first;
+        if (constants.universe_size() != 0)
+            start |= constants;
+        engine.closure(start, closure);
+        if (!is_subset(fd.second, closure))
+            return false;
+    }
+    return true;
+}
+
+bool equivalent(const AttributeFDSet& fds, const AttributeFDSet& other) {
+    return implies_all(fds, other) && implies_all(other, fds);
+}
+
+namespace {
+
+void closure_through(ClosureEngine& engine, ClosureCache *cache, 
+        const AttributeSet& set, AttributeSet& result) {
+    if (cache)
+        cache->closure(engine, set, result);
+    else
+        engine.closure(set, result);
+}
+
+// Drops LR attributes from the superkey S while it still determines U
+AttributeSet minimize_key(ClosureEngine& engine, ClosureCache *cache, const AttributeSet& U, 
+        const AttributeClasses<AttributeSet>& classes, const AttributeSet& S) {
+    AttributeSet result = S - classes.R;
+    AttributeSet closure;
+    (S * classes.LR).for_each([&](int id) {
+        result.erase(id);
+        closure_through(engine, cache, result, closure);
+        if (!is_subset(U, closure)) {
+            result.insert(id);
+        }
+    });
+    return result;
+}
+
+void all_candidate_keys(const AttributeSet& U, const AttributeFDSet& fds, 
+        const std::function<bool(const AttributeSet&)>& on_key, ClosureCache *cache) {
+    DB_PHASE("all_candidate_keys");
+    ClosureEngine engine{fds};
+
+    // Instead of testing S against every key found so far, S is reduced
+    // to a key and duplicates are dropped by hashing.
+    // Pending keys point into the hash set, each key is stored once.
+    std::unordered_set<AttributeSet> keys;
+    std::vector<const AttributeSet *> pending;
+
+    auto add_key = [&keys, &pending, &on_key](AttributeSet key) {
+        auto inserted = keys.insert(std::move(key));
+        if (!inserted.second)
+            return true;
+        pending.push_back(&*inserted.first);
+        return on_key(*inserted.first);
+    };
+
+    // Every key contains the L and N attributes: when they determine U
+    // they are the only key.
+    auto classes = classify_attributes(U, fds);
+    AttributeSet core = classes.L + classes.N;
+    if (is_subset(U, engine.closure(core))) {
+        add_key(core);
+        return;
+    }
+
+    if (!add_key(minimize_key(engine, cache, U, classes, U)))
+        return;
+
+    for (size_t i = 0; i < pending.size(); i++) {
+        for (auto& fd: fds) {
+            if (fd.first.empty() || !pending[i]->intersects(fd.second))
+                continue;
+            AttributeSet S = *pending[i] - fd.second;
+            S |= fd.first;
+            if (!add_key(minimize_key(engine, cache, U, classes, S)))
+                return;
+        }
+    }
+}
+
+} // namespace
+
+void all_candidate_keys(const AttributeSet& U, const AttributeFDSet& fds, 
+        const std::function<bool(const AttributeSet&)>& on_key) {
+    all_candidate_keys(U, fds, on_key, nullptr);
+}
+
+void all_candidate_keys(const AttributeSet& U, const AttributeFDSet& fds, 
+        const std::function<bool(const AttributeSet&)>& on_key, ClosureCache& cache) {
+    all_candidate_keys(U, fds, on_key, &cache);
+}
+
+namespace {
+
+// Reverse search over the minimal transversals of the complements of
+// the maximal non-superkeys, the complements being found on the way.
+// A node is a minimal transversal S of the first level edges. Each
+// member has the indices of its critical edges, those S hits only in it.
+// The children of a node missing an edge add one vertex of the edge.
+// Edges are only ever appended, so the nodes above a level never change.
+class TransversalKeys {
+private:
+    struct Member {
+        int id;
+        std::vector<int> critical;
+    };
+
+    const AttributeSet& U_;
+    const std::function<bool(const AttributeSet&)>& on_key_;
+    ClosureEngine engine_;
+    AttributeSet V_;
+    std::vector<AttributeSet> edges_;
+    AttributeSet closure_;
+
+    bool is_superkey(const AttributeSet& set) {
+        engine_.closure(set, closure_);
+        return is_subset(U_, closure_);
+    }
+
+    // Complement in V of a maximal non-superkey containing S
+    AttributeSet complement_of_maximal(const AttributeSet& S) {
+        engine_.closure(S, closure_);
+        AttributeSet M = closure_ * V_;
+        AttributeSet candidate;
+        (V_ - M).for_each([&](int id) {
+            if (M.contains(id))
+                return;
+            candidate = M;
+            candidate.insert(id);
+            if (!is_superkey(candidate))
+                M = closure_ * V_;
+        });
+        return V_ - M;
+    }
+
+    bool search(AttributeSet& S, std::vector<Member>& members, size_t level) {
+        for (;; level++) {
+            if (level == edges_.size()) {
+                if (is_superkey(S))
+                    return on_key_(S);
+                edges_.push_back(complement_of_maximal(S));
+            }
+            auto& edge = edges_[level];
+            if (!S.intersects(edge))
+                break;
+            if (S.intersection_size(edge) == 1) {
+                for (auto& member: members) {
+                    if (edge.contains(member.id)) {
+                        member.critical.push_back(level);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // A vertex in every critical edge of a member would leave it
+        // without one
+        AttributeSet forbidden(V_.universe_size());
+        for (auto& member: members) {
+            AttributeSet common = edges_[member.critical.front()];
+            for (int e: member.critical) {
+                common &= edges_[e];
+            }
+            forbidden |= common;
+        }
+
+        AttributeSet candidates = edges_[level] - forbidden;
+        for (int v = candidates.next(0); v != -1; v = candidates.next(v + 1)) {
+            std::vector<Member> child;
+            child.reserve(members.size() + 1);
+            for (auto& member: members) {
+                child.push_back(Member{member.id, {}});
+                for (int e: member.critical) {
+                    if (!edges_[e].contains(v))
+                        child.back().critical.push_back(e);
+                }
+            }
+            child.push_back(Member{v, {static_cast<int>(level)}});
+
+            S.insert(v);
+            bool go_on = search(S, child, level + 1);
+            S.erase(v);
+            if (!go_on)
+                return false;
+        }
+        return true;
+    }
+
+public:
+    TransversalKeys(const AttributeSet& U, const AttributeFDSet& fds,
+            const std::function<bool(const AttributeSet&)>& on_key)
+        : U_(U), on_key_(on_key), engine_{fds} {}
+
+    // R attributes are in no key, so vertices and edges are restricted
+    // to V = U - R. The L and N attributes are in every key: V minus one
+    // of them is closed, its complement is the attribute alone. They
+    // make the root, a minimal transversal of these first edges.
+    void run(const AttributeClasses<AttributeSet>& classes) {
+        V_ = U_ - classes.R;
+        AttributeSet core = classes.L + classes.N;
+        std::vector<Member> members;
+        core.for_each([&](int id) {
+            AttributeSet edge(V_.universe_size());
+            edge.insert(id);
+            edges_.push_back(edge);
+            members.push_back(Member{id, {}});
+        });
+        search(core, members, 0);
+    }
+};
+
+} // namespace
+
+void transversal_candidate_keys(const AttributeSet& U, const AttributeFDSet& fds,
+        const std::function<bool(const AttributeSet&)>& on_key) {
+    DB_PHASE("transversal_candidate_keys");
+    TransversalKeys{U, fds, on_key}.run(classify_attributes(U, fds));
+}
+
+std::vector<AttributeSet> transversal_candidate_keys(const AttributeSet& U,
+        const AttributeFDSet& fds, size_t max_keys) {
+    std::vector<AttributeSet> result;
+    if (max_keys == 0)
+        return result;
+    transversal_candidate_keys(U, fds, [&result, max_keys](const AttributeSet& key) {
+        result.push_back(key);
+        return result.size() < max_keys;
+    });
+    return result;
+}
+
+std::vector<FieldSet> transversal_candidate_keys(const FieldSet& U, const FDSet& fds,
+        size_t max_keys) {
+    Schema schema{U + field_set_from(fds)};
+    std::vector<FieldSet> result;
+    for (auto& key: transversal_candidate_keys(schema.encode(U), schema.encode(fds), max_keys)) {
+        result.push_back(schema.decode(key));
+    }
+    return result;
+}
+
+namespace {
+
+// Disables, in the given order, every enabled FD implied by the others.
+void remove_redundant(ClosureEngine& engine, const AttributeFDSet& fds, 
+        const std::vector<int>& order, AttributeSet& closure) {
+    for (int i: order) {
+        engine.set_enabled(i, false);
+        engine.closure(engine.lhs(i), closure);
+        if (!is_subset(fds[i].second, closure))
+            engine.set_enabled(i, true);
+    }
+}
+
+// Same result as remove_redundant(engine, fds, order, closure).
+// order is taken in blocks. Every FD of a block is first checked on pool
+// against two states that bound the one the sequential pass would see:
+// without the FD, and also without the block FDs before it. Removing FDs
+// only shrinks closures, so an FD not implied in the first state is kept
+// and one implied in the second is removed. The FDs in between are then
+// checked in order on engine, and the block is committed to every worker.
+void remove_redundant(ClosureEngine& engine, const AttributeFDSet& fds, 
+        const std::vector<int>& order, AttributeSet& closure, ThreadPool& pool) {
+    enum Verdict: char { keep, remove, unsure };
+
+    int thread_count = pool.thread_count();
+    std::vector<ClosureEngine> engines(thread_count, engine);
+    std::vector<AttributeSet> closures(thread_count, closure);
+    const int block_size = 8 * thread_count;
+    std::vector<char> verdicts(block_size);
+
+    for (size_t begin = 0; begin < order.size(); begin += block_size) {
+        int count = static_cast<int>(std::min(order.size() - begin, size_t(block_size)));
+        const int *block = order.data() + begin;
+
+        pool.parallel_for(count, [&](int k, int worker) {
+            auto& worker_engine = engines[worker];
+            auto& worker_closure = closures[worker];
+            int i = block[k];
+            worker_engine.set_enabled(i, false);
+            worker_engine.closure(worker_engine.lhs(i), worker_closure);
+            verdicts[k] = keep;
+            if (is_subset(fds[i].second, worker_closure)) {
+                for (int j = 0; j < k; j++) {
+                    worker_engine.set_enabled(block[j], false);
+                }
+                worker_engine.closure(worker_engine.lhs(i), worker_closure);
+                verdicts[k] = is_subset(fds[i].second, worker_closure) ? remove : unsure;
+                for (int j = 0; j < k; j++) {
+                    worker_engine.set_enabled(block[j], true);
+                }
+            }
+            worker_engine.set_enabled(i, true);
+        });
+
+        for (int k = 0; k < count; k++) {
+            int i = block[k];
+            if (verdicts[k] == remove) {
+                engine.set_enabled(i, false);
+            }
+            else if (verdicts[k] == unsure) {
+                engine.set_enabled(i, false);
+                engine.closure(engine.lhs(i), closure);
+                if (!is_subset(fds[i].second, closure))
+                    engine.set_enabled(i, true);
+            }
+        }
+
+        for (auto& worker_engine: engines) {
+            for (int k = 0; k < count; k++) {
+                worker_engine.set_enabled(block[k], engine.enabled(block[k]));
+            }
+        }
+    }
+}
+
+struct AttributeFDHash {
+    std::size_t operator () (const AttributeFD& fd) const {
+        return fd.first.hash() * 31 + fd.second.hash();
+    }
+};
+
+// The enabled FDs, as they are after the reductions so far
+using FDIndex = std::unordered_set<AttributeFD, AttributeFDHash>;
+
+// The first LHS attribute of fd that can be removed with the FD still
+// following from the enabled FDs, -1 when there is none.
+// Shrinking or disabling in reduce_lhs keeps the FD set equivalent, so
+// the answer does not depend on the reductions made before, and cached
+// closures stay valid throughout.
+int extraneous_attribute(ClosureEngine& engine, ClosureCache *cache, const AttributeFD& fd, 
+        AttributeSet& modified_set, AttributeSet& closure) {
+    if (fd.first.size() < 2)
+        return -1;
+
+    modified_set = fd.first;
+    for (int id = fd.first.next(0); id >= 0; id = fd.first.next(id + 1)) {
+        modified_set.erase(id);
+        closure_through(engine, cache, modified_set, closure);
+        if (is_subset(fd.second, closure))
+            return id;
+        modified_set.insert(id);
+    }
+    return -1;
+}
+
+// Removes the LHS attribute id of fds[i], as step 2 of the FDSet version
+// does. When the reduced FD is already in the cover the entry is disabled
+// instead, which keeps the set semantics.
+void reduce_lhs(ClosureEngine& engine, AttributeFDSet& fds, int i, int id, FDIndex& enabled_fds) {
+    auto& fd = fds[i];
+    AttributeFD reduced = fd;
+    reduced.first.erase(id);
+    enabled_fds.erase(fd);
+    if (enabled_fds.count(reduced)) {
+        engine.set_enabled(i, false);
+        return;
+    }
+
+    engine.shrink_lhs(i, reduced.first);
+    fd.first = std::move(reduced.first);
+    enabled_fds.insert(fd);
+}
+
+// Indices of the enabled FDs, in FD order
+std::vector<int> sorted_enabled(const ClosureEngine& engine, const AttributeFDSet& fds) {
+    std::vector<int> result;
+    for (size_t i = 0; i < fds.size(); i++) {
+        if (engine.enabled(i))
+            result.push_back(i);
+    }
+    std::sort(result.begin(), result.end(), [&fds](int i, int j) {
+        return fds[i] < fds[j];
+    });
+    return result;
+}
+
+} // namespace
+
+// All checks run on one engine with disabled flags and reuse the same
+// scratch sets: no allocation per closure.
+AttributeFDSet non_redundant(const AttributeFDSet& fds) {
+    ClosureEngine engine{fds};
+    AttributeSet closure(engine.universe_size());
+
+    std::vector<int> order(fds.size());
+    for (size_t i = 0; i < fds.size(); i++) {
+        order[i] = i;
+    }
+    remove_redundant(engine, fds, order, closure);
+
+    AttributeFDSet result;
+    for (size_t i = 0; i < fds.size(); i++) {
+        if (engine.enabled(i))
+            result.push_back(fds[i]);
+    }
+    return result;
+}
+
+namespace {
+
+// Step 2 finds the extraneous attribute of every FD against the step 1
+// FDs, on pool with an engine per worker, then reduces in FD order.
+AttributeFDSet minimal_cover(const AttributeFDSet& fds, ClosureCache *cache, ThreadPool *pool) {
+    DB_PHASE("minimal_cover");
+    AttributeFDSet result;
+    // Step 1
+    for (auto& fd: fds) {
+        fd.second.for_each([&result, &fd](int id) {
+            AttributeSet rhs(fd.second.universe_size());
+            rhs.insert(id);
+            result.emplace_back(fd.first, rhs);
+        });
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    ClosureEngine engine{result};
+    AttributeSet closure(engine.universe_size());
+    AttributeSet modified_set(engine.universe_size());
+
+    // Step 2
+    {
+        DB_PHASE("minimal_cover/left_reduce");
+        FDIndex enabled_fds(result.begin(), result.end());
+        std::vector<int> extraneous(result.size(), -1);
+        if (pool) {
+            int thread_count = pool->thread_count();
+            std::vector<ClosureEngine> engines(thread_count, engine);
+            std::vector<AttributeSet> modified_sets(thread_count, modified_set);
+            std::vector<AttributeSet> closures(thread_count, closure);
+            pool->parallel_for(result.size(), [&](int i, int worker) {
+                extraneous[i] = extraneous_attribute(engines[worker], cache, result[i], 
+                        modified_sets[worker], closures[worker]);
+            });
+        }
+
+        for (size_t i = 0; i < result.size(); i++) {
+            int id = pool ? extraneous[i] : 
+                extraneous_attribute(engine, cache, result[i], modified_set, closure);
+            if (id >= 0)
+                reduce_lhs(engine, result, i, id, enabled_fds);
+        }
+    }
+
+    // Step 3, in the order of the reduced cover
+    auto order = sorted_enabled(engine, result);
+    {
+        DB_PHASE("minimal_cover/non_redundant");
+        if (pool) {
+            remove_redundant(engine, result, order, closure, *pool);
+        }
+        else {
+            remove_redundant(engine, result, order, closure);
+        }
+    }
+
+    AttributeFDSet cover;
+    for (int i: order) {
+        if (engine.enabled(i))
+            cover.push_back(result[i]);
+    }
+    return cover;
+}
+
+} // namespace
+
+AttributeFDSet minimal_cover(const AttributeFDSet& fds) {
+    return minimal_cover(fds, nullptr, nullptr);
+}
+
+AttributeFDSet minimal_cover(const AttributeFDSet& fds, ClosureCache& cache) {
+    return minimal_cover(fds, &cache, nullptr);
+}
+
+AttributeFDSet minimal_cover(const AttributeFDSet& fds, ThreadPool& pool) {
+    // One thread would only add the speculative closures
+    return minimal_cover(fds, nullptr, pool.thread_count() > 1 ? &pool : nullptr);
+}
+
+FDSet minimal_cover(const FDSet& fds, ThreadPool& pool) {
+    Schema schema{field_set_from(fds)};
+    return schema.decode(minimal_cover(schema.encode(fds), pool));
+}
+
+// Maier's algorithm. FDs with the same LHS are combined and redundant
+// ones removed, then the FDs are grouped by the closure of their LHS.
+// X directly determines Y in its class when Y is in the closure of X
+// under the FDs of the other classes; X -> U can then be dropped and
+// U moved to the RHS of Y. Only the classes with smaller closures fire in
+// these closures and each merge keeps the FDs equivalent, so they are
+// computed once, and a class is done when no FD directly determines a
+// remaining one.
+AttributeFDSet minimum_cover(const AttributeFDSet& fds) {
+    DB_PHASE("minimum_cover");
+    AttributeFDSet combined = fds;
+    std::sort(combined.begin(), combined.end());
+    AttributeFDSet by_lhs;
+    for (auto& fd: combined) {
+        if (!by_lhs.empty() && by_lhs.back().first == fd.first)
+            by_lhs.back().second |= fd.second;
+        else
+            by_lhs.push_back(fd);
+    }
+    auto G = non_redundant(by_lhs);
+
+    ClosureEngine engine{G};
+    std::unordered_map<AttributeSet, std::vector<int>> classes;
+    for (size_t i = 0; i < G.size(); i++) {
+        classes[engine.closure(G[i].first)].push_back(i);
+    }
+
+    std::vector<char> alive(G.size(), 1);
+    AttributeSet direct;
+    for (auto& e: classes) {
+        auto& members = e.second;
+        if (members.size() < 2)
+            continue;
+
+        for (int i: members) {
+            engine.set_enabled(i, false);
+        }
+        for (int i: members) {
+            engine.closure(G[i].first, direct);
+            auto target = std::find_if(members.begin(), members.end(), [&](int j) {
+                return j != i && alive[j] && is_subset(G[j].first, direct);
+            });
+            if (target != members.end()) {
+                G[*target].second |= G[i].second;
+                alive[i] = false;
+            }
+        }
+        for (int i: members) {
+            engine.set_enabled(i, true);
+        }
+    }
+
+    AttributeFDSet result;
+    for (size_t i = 0; i < G.size(); i++) {
+        if (alive[i])
+            result.emplace_back(G[i].first, G[i].second - G[i].first);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+FDSet minimum_cover(const FDSet& fds) {
+    Schema schema{field_set_from(fds)};
+    return schema.decode(minimum_cover(schema.encode(fds)));
+}
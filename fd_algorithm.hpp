@@ -2,17 +2,127 @@
 #define DB_ALGORITHM_HPP
 
 #include "util.hpp"
+#include "attribute_set.hpp"
+#include <functional>
+#include <limits>
+#include <vector>
+
+class ClosureCache;
+class ThreadPool;
+
+// Attributes of U classified by the sides of the FDs they appear on:
+// L only on left-hand sides, R only on right-hand sides, LR on both,
+// N on none. L and N attributes are in every key, R attributes in none.
+// FDs with an empty LHS are ignored, as in closure_of.
+template <typename SetType>
+struct AttributeClasses {
+    SetType L, R, LR, N;
+};
+
+AttributeClasses<FieldSet> classify_attributes(const FieldSet& U, const FDSet& fds);
 
 FieldSet closure_of(const FieldSet& set, const FDSet& fds);
 
 FieldSet candidate_key(const FieldSet& U, const FDSet& fds);
 
+// Enumerates every candidate key with the Lucchesi-Osborn algorithm.
+// Keys are passed to on_key as soon as they are found,
+// the enumeration stops when on_key returns false.
+void all_candidate_keys(const FieldSet& U, const FDSet& fds, 
+        const std::function<bool(const FieldSet&)>& on_key);
+
+std::vector<FieldSet> all_candidate_keys(const FieldSet& U, const FDSet& fds);
+
+// Enumerates every candidate key as a minimal transversal of the
+// complements of the maximal non-superkeys, for large schemas with many
+// keys. The complements are not computed upfront: a reverse search over
+// the minimal transversals of those found so far (Murakami and Uno's RS)
+// extends each transversal that is not a superkey to a maximal
+// non-superkey and adds its complement (dualize and advance).
+// Vertices that would leave a member without a critical edge are
+// pruned with one bitset per node. Every node costs time polynomial in
+// the sizes of U, fds and the complements found, keys are reported once
+// and as soon as they are reached. No polynomial delay is known for this
+// dualization in general: a subtree may end without a key.
+// Stops after max_keys keys.
+std::vector<FieldSet> transversal_candidate_keys(const FieldSet& U, const FDSet& fds,
+        size_t max_keys = std::numeric_limits<size_t>::max());
+
 bool equivalent_after_remove(const FDSet& fds, const FD& fd);
 
 bool equivalent_after_replace(const FDSet& fds, const FD& oldfd, const FD& newfd);
 
+// True if fd follows from fds: its RHS is in the closure of its LHS.
+// Unlike closure_of, FDs of fds with an empty LHS are applied: their RHS
+// is added to every closure, as they hold whatever the LHS.
+bool implies(const FDSet& fds, const FD& fd);
+
+// True if every FD of other follows from fds, in the same sense.
+// fds is compiled once and each FD of other costs one closure, stopping
+// at the first that fails. FDs of other that are trivial or also in fds
+// are not checked.
+bool implies_all(const FDSet& fds, const FDSet& other);
+
+// True if fds and other are covers of each other
+bool equivalent(const FDSet& fds, const FDSet& other);
+
 FDSet non_redundant(const FDSet& fds);
 
 FDSet minimal_cover(const FDSet& fds);
 
+// Equivalent FD set with the fewest FDs, RHS being sets (Maier 1980).
+// Polynomial, unlike a cover with the fewest attributes. FDs are
+// combined by LHS, so the result is not left-reduced and its RHS are
+// not single attributes. FDs with an empty LHS are kept as they are,
+// like closure_of ignores them.
+FDSet minimum_cover(const FDSet& fds);
+
+// Schema-compiled mode.
+// Same results as the FieldSet versions when the sets are encoded
+// with a Schema built from the universe (see Schema).
+AttributeClasses<AttributeSet> classify_attributes(
+        const AttributeSet& U, const AttributeFDSet& fds);
+
+AttributeSet closure_of(const AttributeSet& set, const AttributeFDSet& fds);
+
+AttributeSet candidate_key(const AttributeSet& U, const AttributeFDSet& fds);
+
+bool implies(const AttributeFDSet& fds, const AttributeFD& fd);
+
+bool implies_all(const AttributeFDSet& fds, const AttributeFDSet& other);
+
+bool equivalent(const AttributeFDSet& fds, const AttributeFDSet& other);
+
+void all_candidate_keys(const AttributeSet& U, const AttributeFDSet& fds, 
+        const std::function<bool(const AttributeSet&)>& on_key);
+
+// Keys are passed to on_key as soon as they are found,
+// the enumeration stops when on_key returns false.
+void transversal_candidate_keys(const AttributeSet& U, const AttributeFDSet& fds,
+        const std::function<bool(const AttributeSet&)>& on_key);
+
+std::vector<AttributeSet> transversal_candidate_keys(const AttributeSet& U,
+        const AttributeFDSet& fds, size_t max_keys = std::numeric_limits<size_t>::max());
+
+AttributeFDSet non_redundant(const AttributeFDSet& fds);
+
+AttributeFDSet minimal_cover(const AttributeFDSet& fds);
+
+AttributeFDSet minimum_cover(const AttributeFDSet& fds);
+
+// Same, with the closures that are only checked against the whole FD set
+// (key minimization, LHS reduction) looked up in cache first.
+// cache must only hold closures under fds.
+void all_candidate_keys(const AttributeSet& U, const AttributeFDSet& fds, 
+        const std::function<bool(const AttributeSet&)>& on_key, ClosureCache& cache);
+
+AttributeFDSet minimal_cover(const AttributeFDSet& fds, ClosureCache& cache);
+
+// Same cover as minimal_cover(fds), with the closures of LHS reduction
+// and redundancy elimination spread over pool. Decisions are committed
+// in the sequential order, so the result is the same for any thread count.
+AttributeFDSet minimal_cover(const AttributeFDSet& fds, ThreadPool& pool);
+
+FDSet minimal_cover(const FDSet& fds, ThreadPool& pool);
+
 #endif
@@ -0,0 +1,485 @@
+#include "fd_discovery.hpp"
+#include "instrumentation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+
+namespace detail {
+
+StrippedPartition partition_of_rows(int row_count) {
+    StrippedPartition result;
+    if (row_count >= 2) {
+        result.rows.resize(row_count);
+        for (int row = 0; row < row_count; row++) {
+            result.rows[row] = row;
+        }
+        result.offsets.push_back(row_count);
+    }
+    return result;
+}
+
+StrippedPartition partition_of_column(const std::vector<std::int32_t>& codes, int distinct_count) {
+    std::vector<std::int32_t> counts(distinct_count, 0);
+    for (auto code: codes) {
+        counts[code]++;
+    }
+
+    // Reuse counts as the write position of every non-singleton class
+    StrippedPartition result;
+    std::int32_t size = 0;
+    for (auto& count: counts) {
+        if (count < 2) {
+            count = -1;
+            continue;
+        }
+        std::int32_t start = size;
+        size += count;
+        count = start;
+        result.offsets.push_back(size);
+    }
+
+    result.rows.resize(size);
+    for (std::int32_t row = 0; row < static_cast<std::int32_t>(codes.size()); row++) {
+        auto& position = counts[codes[row]];
+        if (position != -1)
+            result.rows[position++] = row;
+    }
+    return result;
+}
+
+bool refines(const StrippedPartition& partition, const std::vector<std::int32_t>& codes) {
+    for (int i = 0; i < partition.class_count(); i++) {
+        auto code = codes[partition.rows[partition.offsets[i]]];
+        for (auto k = partition.offsets[i] + 1; k < partition.offsets[i + 1]; k++) {
+            if (codes[partition.rows[k]] != code)
+                return false;
+        }
+    }
+    return true;
+}
+
+std::int64_t violations(const StrippedPartition& partition, const std::vector<std::int32_t>& codes,
+        std::vector<std::int32_t>& counts) {
+    std::int64_t result = 0;
+    for (int i = 0; i < partition.class_count(); i++) {
+        auto begin = partition.rows.begin() + partition.offsets[i];
+        auto end = partition.rows.begin() + partition.offsets[i + 1];
+        std::int32_t most = 0;
+        for (auto it = begin; it != end; ++it) {
+            most = std::max(most, ++counts[codes[*it]]);
+        }
+        result += (end - begin) - most;
+        for (auto it = begin; it != end; ++it) {
+            counts[codes[*it]] = 0;
+        }
+    }
+    return result;
+}
+
+StrippedPartition PartitionProduct::operator () (
+        const StrippedPartition& left, const StrippedPartition& right) {
+    StrippedPartition result;
+    if (left.is_key() || right.is_key())
+        return result;
+
+    if (static_cast<int>(buckets_.size()) < left.class_count())
+        buckets_.resize(left.class_count());
+    for (int i = 0; i < left.class_count(); i++) {
+        for (auto k = left.offsets[i]; k < left.offsets[i + 1]; k++) {
+            class_of_[left.rows[k]] = i;
+        }
+    }
+
+    result.rows.reserve(std::min(left.rows.size(), right.rows.size()));
+    for (int j = 0; j < right.class_count(); j++) {
+        auto begin = right.rows.begin() + right.offsets[j];
+        auto end = right.rows.begin() + right.offsets[j + 1];
+        for (auto it = begin; it != end; ++it) {
+            auto i = class_of_[*it];
+            if (i != -1)
+                buckets_[i].push_back(*it);
+        }
+        for (auto it = begin; it != end; ++it) {
+            auto i = class_of_[*it];
+            if (i == -1)
+                continue;
+            auto& bucket = buckets_[i];
+            if (bucket.size() >= 2) {
+                result.rows.insert(result.rows.end(), bucket.begin(), bucket.end());
+                result.offsets.push_back(static_cast<std::int32_t>(result.rows.size()));
+            }
+            bucket.clear();
+        }
+    }
+
+    for (auto row: left.rows) {
+        class_of_[row] = -1;
+    }
+    result.rows.shrink_to_fit();
+    result.offsets.shrink_to_fit();
+    return result;
+}
+
+} // namespace detail
+
+namespace {
+
+struct LatticeNode {
+    AttributeSet set;
+    // C+(X) of the TANE paper: the attributes A for which no
+    // X - {A, B} -> B holds, only those can still give minimal FDs
+    AttributeSet candidates;
+    detail::StrippedPartition partition;
+    // Partition of the sampled rows, empty without sampling
+    detail::StrippedPartition sample;
+};
+
+using Level = std::vector<LatticeNode>;
+
+using LevelIndex = std::unordered_map<AttributeSet, int>;
+
+LevelIndex index_of(const Level& level) {
+    LevelIndex result;
+    result.reserve(level.size());
+    for (int i = 0; i < static_cast<int>(level.size()); i++) {
+        result.emplace(level[i].set, i);
+    }
+    return result;
+}
+
+AttributeSet without(const AttributeSet& set, int id) {
+    AttributeSet result = set;
+    result.erase(id);
+    return result;
+}
+
+AttributeSet single(int universe_size, int id) {
+    AttributeSet result(universe_size);
+    result.insert(id);
+    return result;
+}
+
+AttributeSet without_last(const AttributeSet& set) {
+    int last = -1;
+    set.for_each([&](int id) { last = id; });
+    return last == -1 ? set : without(set, last);
+}
+
+struct FoundFD {
+    AttributeFD fd;
+    double error;
+};
+
+using FoundFDs = std::vector<std::vector<FoundFD>>;
+
+using ErrorCallback = std::function<void(const AttributeFD&, double)>;
+
+void emit(const FoundFDs& found, const ErrorCallback& on_fd) {
+    for (auto& fds: found) {
+        for (auto& found_fd: fds) {
+            on_fd(found_fd.fd, found_fd.error);
+        }
+    }
+}
+
+// Level-wise search of the minimal FDs X -> A with at most max_violations
+// rows to remove for them to hold. With no violations allowed this is
+// plain TANE; otherwise candidates are rejected by the cheap lower bounds
+// e(X) - e(X + A) and the violations on a row sample before they are
+// counted on the full data.
+class LatticeSearch {
+private:
+    const Dataset& data_;
+    ThreadPool& pool_;
+    AttributeSet R_;
+    std::int64_t max_violations_;
+    // Violations on the sample above which a candidate is rejected
+    std::int64_t max_sample_violations_;
+    std::vector<std::int32_t> sample_rows_;
+    std::vector<std::vector<std::int32_t>> sample_columns_;
+    std::vector<detail::PartitionProduct> products_;
+    std::vector<detail::PartitionProduct> sample_products_;
+    std::vector<std::vector<std::int32_t>> counts_;
+
+    bool exact() const {
+        return max_violations_ == 0;
+    }
+
+    bool sampled() const {
+        return !sample_rows_.empty();
+    }
+
+    void compute_dependencies(LatticeNode& node, const Level& previous,
+            const LevelIndex& previous_index, int worker, std::vector<FoundFD>& found);
+
+    bool keep(const LatticeNode& node, const Level& previous,
+            const LevelIndex& previous_index, std::vector<FoundFD>& found);
+
+    Level next_level(Level& level);
+
+public:
+    LatticeSearch(const Dataset& data, const ApproximateFDOptions& options, ThreadPool& pool);
+
+    void run(const ErrorCallback& on_fd);
+};
+
+LatticeSearch::LatticeSearch(const Dataset& data, const ApproximateFDOptions& options,
+        ThreadPool& pool)
+    : data_(data), pool_(pool), R_(data.column_count()),
+    max_violations_{static_cast<std::int64_t>(options.max_error * data.row_count() + 1e-9)},
+    max_sample_violations_{max_violations_},
+    products_(pool.thread_count(), detail::PartitionProduct{data.row_count()}) {
+    for (int c = 0; c < data.column_count(); c++) {
+        R_.insert(c);
+    }
+    if (exact())
+        return;
+
+    int max_domain = 0;
+    for (int c = 0; c < data.column_count(); c++) {
+        max_domain = std::max(max_domain, data.distinct_count(c));
+    }
+    counts_.assign(pool.thread_count(), std::vector<std::int32_t>(max_domain, 0));
+
+    int sample_size = options.sample_size;
+    if (sample_size <= 0 || sample_size >= data.row_count())
+        return;
+
+    // The violations on the sample are at most its rows among those to
+    // remove from the full data. For an FD within max_error these are
+    // hypergeometric with mean max_error * sample_size, and by Hoeffding's
+    // bound exceed it by t with probability at most exp(-2 t^2 / sample_size).
+    // The sample never has more violations than the full data, so the
+    // full budget stays a bound that never rejects a kept FD.
+    if (options.sample_miss_probability > 0) {
+        double margin = std::sqrt(sample_size * std::log(1 / options.sample_miss_probability) / 2);
+        double scaled = options.max_error * sample_size + margin;
+        if (scaled < max_sample_violations_)
+            max_sample_violations_ = static_cast<std::int64_t>(scaled);
+    }
+
+    // Partial Fisher-Yates shuffle, sorted back for locality
+    std::vector<std::int32_t> rows(data.row_count());
+    for (int row = 0; row < data.row_count(); row++) {
+        rows[row] = row;
+    }
+    std::mt19937 random{options.seed};
+    for (int i = 0; i < sample_size; i++) {
+        std::uniform_int_distribution<int> pick{i, data.row_count() - 1};
+        std::swap(rows[i], rows[pick(random)]);
+    }
+    sample_rows_.assign(rows.begin(), rows.begin() + sample_size);
+    std::sort(sample_rows_.begin(), sample_rows_.end());
+
+    for (int c = 0; c < data.column_count(); c++) {
+        std::vector<std::int32_t> codes;
+        codes.reserve(sample_size);
+        for (auto row: sample_rows_) {
+            codes.push_back(data.column(c)[row]);
+        }
+        sample_columns_.push_back(std::move(codes));
+    }
+    sample_products_.assign(pool.thread_count(), detail::PartitionProduct{sample_size});
+}
+
+void LatticeSearch::compute_dependencies(LatticeNode& node, const Level& previous,
+        const LevelIndex& previous_index, int worker, std::vector<FoundFD>& found) {
+    node.candidates = R_;
+    node.set.for_each([&](int a) {
+        node.candidates &= previous[previous_index.at(without(node.set, a))].candidates;
+    });
+
+    int error = node.partition.error();
+    (node.set * node.candidates).for_each([&](int a) {
+        auto lhs = without(node.set, a);
+        auto& below = previous[previous_index.at(lhs)];
+        if (below.partition.error() == error) {
+            found.push_back(FoundFD{AttributeFD{lhs, single(R_.universe_size(), a)}, 0.0});
+            node.candidates.erase(a);
+            node.candidates &= node.set;
+            return;
+        }
+        if (exact() || below.partition.error() - error > max_violations_)
+            return;
+
+        auto& counts = counts_[worker];
+        if (sampled() && detail::violations(below.sample, sample_columns_[a], counts) > 
+                max_sample_violations_) {
+            DB_COUNT(sample_rejections, 1);
+            return;
+        }
+        auto violations = detail::violations(below.partition, data_.column(a), counts);
+        if (violations > max_violations_)
+            return;
+        found.push_back(FoundFD{AttributeFD{lhs, single(R_.universe_size(), a)},
+            static_cast<double>(violations) / data_.row_count()});
+        node.candidates.erase(a);
+    });
+}
+
+// Whether the node stays in the lattice. In exact mode superkeys are
+// dropped after emitting their minimal FDs, checked directly against the
+// partitions of the previous level: X -> A is minimal iff no X - B
+// determines A. An approximate X - B -> B may still need the supersets
+// of a key, so they are kept then.
+bool LatticeSearch::keep(const LatticeNode& node, const Level& previous,
+        const LevelIndex& previous_index, std::vector<FoundFD>& found) {
+    if (node.candidates.empty())
+        return false;
+    if (!exact() || !node.partition.is_key())
+        return true;
+
+    (node.candidates - node.set).for_each([&](int a) {
+        bool minimal = true;
+        node.set.for_each([&](int b) {
+            if (minimal) {
+                auto& subset = previous[previous_index.at(without(node.set, b))];
+                minimal = !detail::refines(subset.partition, data_.column(a));
+            }
+        });
+        if (minimal)
+            found.push_back(FoundFD{AttributeFD{node.set, single(R_.universe_size(), a)}, 0.0});
+    });
+    return false;
+}
+
+// Joins the sets of level that differ only in their last attribute,
+// keeping the joins whose subsets all survived pruning.
+// The partitions of level are only read while the products run.
+Level LatticeSearch::next_level(Level& level) {
+    std::sort(level.begin(), level.end(), [](const LatticeNode& x, const LatticeNode& y) {
+        return x.set < y.set;
+    });
+    auto index = index_of(level);
+
+    Level result;
+    std::vector<std::pair<int, int>> joined;
+    int size = static_cast<int>(level.size());
+    for (int begin = 0, end = 0; begin < size; begin = end) {
+        auto prefix = without_last(level[begin].set);
+        for (end = begin + 1; end < size && without_last(level[end].set) == prefix; end++);
+
+        for (int i = begin; i < end; i++) {
+            for (int j = i + 1; j < end; j++) {
+                auto set = level[i].set + level[j].set;
+                bool all_present = true;
+                prefix.for_each([&](int id) {
+                    if (all_present)
+                        all_present = index.count(without(set, id)) != 0;
+                });
+                if (!all_present)
+                    continue;
+                result.push_back(LatticeNode{set, AttributeSet{}, 
+                    detail::StrippedPartition{}, detail::StrippedPartition{}});
+                joined.emplace_back(i, j);
+            }
+        }
+    }
+
+    pool_.parallel_for(static_cast<int>(result.size()), [&](int k, int worker) {
+        auto& left = level[joined[k].first];
+        auto& right = level[joined[k].second];
+        result[k].partition = products_[worker](left.partition, right.partition);
+        if (sampled())
+            result[k].sample = sample_products_[worker](left.sample, right.sample);
+    });
+    return result;
+}
+
+void LatticeSearch::run(const ErrorCallback& on_fd) {
+    int n = data_.column_count();
+    Level previous(1);
+    previous[0].set = AttributeSet(n);
+    previous[0].candidates = R_;
+    previous[0].partition = detail::partition_of_rows(data_.row_count());
+    previous[0].sample = detail::partition_of_rows(static_cast<int>(sample_rows_.size()));
+
+    Level level(n);
+    pool_.parallel_for(n, [&](int c, int) {
+        level[c].set = single(n, c);
+        level[c].partition = detail::partition_of_column(data_.column(c), data_.distinct_count(c));
+        if (sampled())
+            level[c].sample = detail::partition_of_column(sample_columns_[c], data_.distinct_count(c));
+    });
+
+    while (!level.empty()) {
+        auto previous_index = index_of(previous);
+        int size = static_cast<int>(level.size());
+
+        FoundFDs found(size);
+        pool_.parallel_for(size, [&](int i, int worker) {
+            compute_dependencies(level[i], previous, previous_index, worker, found[i]);
+        });
+        emit(found, on_fd);
+
+        // vector<bool> is not safe to write from several threads
+        FoundFDs found_by_keys(size);
+        std::vector<char> kept(size);
+        pool_.parallel_for(size, [&](int i, int) {
+            kept[i] = keep(level[i], previous, previous_index, found_by_keys[i]);
+        });
+        emit(found_by_keys, on_fd);
+
+        previous.clear();
+        for (int i = 0; i < size; i++) {
+            if (kept[i])
+                previous.push_back(std::move(level[i]));
+        }
+        level = next_level(previous);
+    }
+}
+
+} // namespace
+
+void discover_fds(const Dataset& data, const std::function<void(const AttributeFD&)>& on_fd,
+        ThreadPool& pool) {
+    ApproximateFDOptions exact;
+    exact.max_error = 0;
+    exact.sample_size = 0;
+    LatticeSearch{data, exact, pool}.run([&](const AttributeFD& fd, double) {
+        on_fd(fd);
+    });
+}
+
+void discover_fds(const Dataset& data, const std::function<void(const AttributeFD&)>& on_fd) {
+    ThreadPool pool{1};
+    discover_fds(data, on_fd, pool);
+}
+
+FDSet discover_fds(const Dataset& data, ThreadPool& pool) {
+    auto schema = data.schema();
+    FDSet result;
+    discover_fds(data, [&](const AttributeFD& fd) {
+        result.insert(schema.decode(fd));
+    }, pool);
+    return result;
+}
+
+FDSet discover_fds(const Dataset& data) {
+    ThreadPool pool{1};
+    return discover_fds(data, pool);
+}
+
+void discover_approximate_fds(const Dataset& data, const ApproximateFDOptions& options,
+        const std::function<void(const AttributeFD&, double)>& on_fd, ThreadPool& pool) {
+    LatticeSearch{data, options, pool}.run(on_fd);
+}
+
+void discover_approximate_fds(const Dataset& data, const ApproximateFDOptions& options,
+        const std::function<void(const AttributeFD&, double)>& on_fd) {
+    ThreadPool pool{1};
+    discover_approximate_fds(data, options, on_fd, pool);
+}
+
+FDSet discover_approximate_fds(const Dataset& data, const ApproximateFDOptions& options,
+        std::map<FD, double>& errors) {
+    auto schema = data.schema();
+    FDSet result;
+    discover_approximate_fds(data, options, [&](const AttributeFD& fd, double error) {
+        auto decoded = schema.decode(fd);
+        result.insert(decoded);
+        errors[decoded] = error;
+    });
+    return result;
+}
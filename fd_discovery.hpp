@@ -0,0 +1,112 @@
+#ifndef DB_FD_DISCOVERY_HPP
+#define DB_FD_DISCOVERY_HPP
+
+#include "dataset.hpp"
+#include "thread_pool.hpp"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace detail {
+
+// Partition of the rows by their values on an attribute set, with the
+// singleton classes stripped. Classes are stored back to back:
+// class i is rows[offsets[i]] .. rows[offsets[i + 1] - 1].
+struct StrippedPartition {
+    std::vector<std::int32_t> rows;
+    std::vector<std::int32_t> offsets{0};
+
+    int class_count() const {
+        return static_cast<int>(offsets.size()) - 1;
+    }
+
+    // Number of rows to remove for the attribute set to become a key:
+    // X -> A holds iff error(X) == error(X + A).
+    int error() const {
+        return static_cast<int>(rows.size()) - class_count();
+    }
+
+    bool is_key() const {
+        return rows.empty();
+    }
+};
+
+// The partition of the empty set: all rows in one class.
+StrippedPartition partition_of_rows(int row_count);
+
+StrippedPartition partition_of_column(const std::vector<std::int32_t>& codes, int distinct_count);
+
+// True if every class of partition is constant on codes,
+// i.e. the attribute set of partition determines the column.
+bool refines(const StrippedPartition& partition, const std::vector<std::int32_t>& codes);
+
+// Rows to remove so that every class of partition is constant on codes,
+// the g3 error of X -> A times the row count. counts is zeroed scratch
+// covering the codes, it is zeroed again on return.
+std::int64_t violations(const StrippedPartition& partition, const std::vector<std::int32_t>& codes,
+        std::vector<std::int32_t>& counts);
+
+// Computes products of stripped partitions in time linear in their sizes.
+// Keeps its scratch buffers between calls, not thread-safe.
+class PartitionProduct {
+private:
+    std::vector<std::int32_t> class_of_;
+    std::vector<std::vector<std::int32_t>> buckets_;
+
+public:
+    explicit PartitionProduct(int row_count): class_of_(row_count, -1) {}
+
+    StrippedPartition operator () (const StrippedPartition& left, const StrippedPartition& right);
+};
+
+} // namespace detail
+
+// Finds the minimal non-trivial FDs X -> A that hold in data, with the
+// level-wise TANE search (Huhtala et al.) over stripped partitions.
+// Only the partitions of two lattice levels are alive at a time.
+// Column c of data is attribute c of data.schema(), FDs are passed to
+// on_fd level by level. Constant columns give FDs with an empty LHS.
+void discover_fds(const Dataset& data, const std::function<void(const AttributeFD&)>& on_fd);
+
+// Same FDs, one per RHS attribute.
+FDSet discover_fds(const Dataset& data);
+
+// Parallel search: the nodes of each level are checked and the partition
+// products of the next level computed on pool. The partitions of a level
+// are read-only while workers use them. FDs are passed to on_fd on the
+// calling thread in the same order for any thread count.
+void discover_fds(const Dataset& data, const std::function<void(const AttributeFD&)>& on_fd,
+        ThreadPool& pool);
+
+FDSet discover_fds(const Dataset& data, ThreadPool& pool);
+
+struct ApproximateFDOptions {
+    // Largest g3 error kept: the fraction of rows to remove for the FD to hold
+    double max_error = 0.01;
+    // Rows of the sample that rejects candidates before they are checked
+    // on the full data, 0 for no sampling. A candidate is rejected when the
+    // sample has more violations than max_error of its rows plus a margin,
+    // or than the budget of the full data.
+    int sample_size = 10000;
+    // Bound on the probability that the sample rejects a given FD within
+    // max_error. The margin grows with the square root of the sample size
+    // and of log(1 / sample_miss_probability). With 0 only the budget of
+    // the full data rejects, which never changes the result but rarely
+    // rejects anything once the data is much larger than the sample.
+    double sample_miss_probability = 1e-6;
+    unsigned seed = 1;
+};
+
+// Finds the minimal X -> A with a g3 error of at most options.max_error,
+// no X - B -> A having one. FDs are passed to on_fd with their errors.
+void discover_approximate_fds(const Dataset& data, const ApproximateFDOptions& options,
+        const std::function<void(const AttributeFD&, double)>& on_fd, ThreadPool& pool);
+
+void discover_approximate_fds(const Dataset& data, const ApproximateFDOptions& options,
+        const std::function<void(const AttributeFD&, double)>& on_fd);
+
+FDSet discover_approximate_fds(const Dataset& data, const ApproximateFDOptions& options,
+        std::map<FD, double>& errors);
+
+#endif
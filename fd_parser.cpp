@@ -0,0 +1,171 @@
+#include "fd_parser.hpp"
+#include "dataset.hpp"
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+bool is_blank(char ch) {
+    return ch == ' ' || ch == '\t';
+}
+
+// FDs as runs of attribute ids: FD i has the LHS ids[offsets[2i]] ..
+// ids[offsets[2i + 1] - 1] and the RHS up to ids[offsets[2i + 2] - 1].
+// Sets are only built once the schema has every name.
+class FDParser {
+private:
+    Schema& schema_;
+    detail::Dictionary names_;
+    // Schema id of every name code
+    std::vector<int> schema_ids_;
+    std::vector<std::int32_t> ids_;
+    std::vector<std::size_t> offsets_{0};
+    int line_ = 0;
+
+    [[noreturn]] void error(const char *message) const {
+        throw std::invalid_argument{"line " + std::to_string(line_) + ": " + message};
+    }
+
+    void add_name(const char *begin, const char *end) {
+        std::int32_t code = names_.encode(begin, end - begin);
+        if (code == static_cast<std::int32_t>(schema_ids_.size())) {
+            schema_ids_.push_back(schema_.add(Field{std::string{begin, end}}));
+        }
+        ids_.push_back(schema_ids_[code]);
+    }
+
+    void parse_side(const char *begin, const char *end) {
+        while (begin != end && is_blank(*begin))
+            begin++;
+        while (begin != end && is_blank(end[-1]))
+            end--;
+        if (begin != end) {
+            for (;;) {
+                auto comma = static_cast<const char *>(std::memchr(begin, ',', end - begin));
+                const char *stop = comma ? comma : end;
+                const char *name_end = stop;
+                while (name_end != begin && is_blank(name_end[-1]))
+                    name_end--;
+                if (name_end == begin)
+                    error("empty attribute name");
+                add_name(begin, name_end);
+                if (!comma)
+                    break;
+                begin = comma + 1;
+                while (begin != end && is_blank(*begin))
+                    begin++;
+            }
+        }
+        offsets_.push_back(ids_.size());
+    }
+
+    // First "->" in [begin, end), nullptr when there is none
+    static const char *find_arrow(const char *begin, const char *end) {
+        for (const char *p = begin;; p++) {
+            p = static_cast<const char *>(std::memchr(p, '-', end - p));
+            if (!p || p + 1 == end)
+                return nullptr;
+            if (p[1] == '>')
+                return p;
+        }
+    }
+
+    void parse_line(const char *begin, const char *end) {
+        line_++;
+        if (begin != end && end[-1] == '\r')
+            end--;
+        const char *p = begin;
+        while (p != end && is_blank(*p))
+            p++;
+        if (p == end || *p == '#')
+            return;
+
+        const char *arrow = find_arrow(p, end);
+        if (!arrow)
+            error("expected ->");
+        if (find_arrow(arrow + 2, end))
+            error("more than one ->");
+        parse_side(p, arrow);
+        parse_side(arrow + 2, end);
+    }
+
+public:
+    explicit FDParser(Schema& schema): schema_(schema) {}
+
+    void parse(const char *begin, const char *end) {
+        while (begin != end) {
+            auto newline = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+            const char *stop = newline ? newline : end;
+            parse_line(begin, stop);
+            begin = newline ? newline + 1 : end;
+        }
+    }
+
+    AttributeFDSet fds() const {
+        AttributeFDSet result;
+        result.reserve(offsets_.size() / 2);
+        AttributeSet set = schema_.empty_set();
+        auto set_of = [this, &set](std::size_t from, std::size_t to) {
+            set.clear();
+            for (std::size_t i = from; i < to; i++) {
+                set.insert(ids_[i]);
+            }
+            return set;
+        };
+        for (std::size_t i = 0; i + 2 < offsets_.size(); i += 2) {
+            result.emplace_back(set_of(offsets_[i], offsets_[i + 1]),
+                    set_of(offsets_[i + 1], offsets_[i + 2]));
+        }
+        return result;
+    }
+};
+
+} // namespace
+
+AttributeFDSet parse_fds(const char *begin, const char *end, Schema& schema) {
+    FDParser parser{schema};
+    parser.parse(begin, end);
+    return parser.fds();
+}
+
+AttributeFDSet parse_fds(const std::string& text, Schema& schema) {
+    return parse_fds(text.data(), text.data() + text.size(), schema);
+}
+
+AttributeFDSet read_fds(std::istream& in, Schema& schema) {
+    std::string text{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    return parse_fds(text, schema);
+}
+
+AttributeFDSet load_fds(const std::string& path, Schema& schema) {
+    detail::File file{path};
+    auto size = file.size();
+    if (size == 0)
+        return AttributeFDSet{};
+
+    detail::Mapping mapping{file, 0, size};
+    return parse_fds(mapping.data(), mapping.data() + size, schema);
+}
+
+void write_fds(std::ostream& out, const Schema& schema, const AttributeFDSet& fds) {
+    auto write_set = [&out, &schema](const AttributeSet& set) {
+        bool first = true;
+        set.for_each([&out, &schema, &first](int id) {
+            if (!first)
+                out << ", ";
+            out << schema.field_of(id);
+            first = false;
+        });
+    };
+
+    for (auto& fd: fds) {
+        write_set(fd.first);
+        out << (fd.first.empty() ? "-> " : " -> ");
+        write_set(fd.second);
+        out << "\n";
+    }
+}
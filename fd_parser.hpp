@@ -0,0 +1,39 @@
+#ifndef DB_FD_PARSER_HPP
+#define DB_FD_PARSER_HPP
+
+#include "attribute_set.hpp"
+#include <istream>
+#include <ostream>
+#include <string>
+
+// FD sets in text, one FD per line:
+//
+//     zip code, street -> city
+//     -> country
+//
+// Attribute names are separated by commas, blanks around them are
+// dropped. A name may contain blanks and any other character except
+// commas, line breaks and "->", which separates the sides. Either side
+// may be empty. Blank lines and lines starting with '#' are skipped,
+// lines may end with "\r\n".
+//
+// Names are tokenized in the buffer and looked up in a hash table of the
+// names seen so far: only a new name is copied and added to schema, then
+// FDs refer to it by its id. FDs are returned in file order, duplicates
+// kept, their sets sized to the final schema.
+// Throws std::invalid_argument naming the line for a line without "->"
+// or with more than one, or with an empty name between commas.
+AttributeFDSet parse_fds(const char *begin, const char *end, Schema& schema);
+
+AttributeFDSet parse_fds(const std::string& text, Schema& schema);
+
+AttributeFDSet read_fds(std::istream& in, Schema& schema);
+
+// Parses a file mapped in memory.
+// Throws std::system_error when the file cannot be read.
+AttributeFDSet load_fds(const std::string& path, Schema& schema);
+
+// Writes fds in the format read by parse_fds
+void write_fds(std::ostream& out, const Schema& schema, const AttributeFDSet& fds);
+
+#endif
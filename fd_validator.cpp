@@ -0,0 +1,156 @@
+#include "fd_validator.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace detail {
+
+std::size_t TupleIndex::hash(const std::int32_t *key) const {
+    std::uint64_t h = 0x9e3779b97f4a7c15ull;
+    for (int i = 0; i < width_; i++) {
+        h = (h ^ static_cast<std::uint32_t>(key[i])) * 0xff51afd7ed558ccdull;
+        h ^= h >> 32;
+    }
+    return static_cast<std::size_t>(h);
+}
+
+void TupleIndex::grow() {
+    slots_.assign(std::max<std::size_t>(16, slots_.size() * 2), -1);
+    std::size_t mask = slots_.size() - 1;
+    for (std::int32_t entry = 0; entry < size(); entry++) {
+        std::size_t i = hash(keys_.data() + entry * width_) & mask;
+        while (slots_[i] != -1) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = entry;
+    }
+}
+
+std::int32_t TupleIndex::insert(const std::int32_t *key, bool& inserted) {
+    // All rows share the empty tuple
+    if (width_ == 0) {
+        inserted = slots_.empty();
+        slots_.assign(1, 0);
+        return 0;
+    }
+
+    if (2 * (size() + 1) > static_cast<int>(slots_.size()))
+        grow();
+
+    std::size_t mask = slots_.size() - 1;
+    std::size_t i = hash(key) & mask;
+    for (; slots_[i] != -1; i = (i + 1) & mask) {
+        auto entry = slots_[i];
+        if (std::equal(key, key + width_, keys_.begin() + entry * width_)) {
+            inserted = false;
+            return entry;
+        }
+    }
+
+    auto entry = static_cast<std::int32_t>(size());
+    keys_.insert(keys_.end(), key, key + width_);
+    slots_[i] = entry;
+    inserted = true;
+    return entry;
+}
+
+} // namespace detail
+
+FDValidator::FDValidator(const FDSet& fds, std::vector<Field> header)
+    : header_{std::move(header)}, dictionaries_(header_.size()), codes_(header_.size()) {
+    auto columns_of = [&](const FieldSet& fields) {
+        std::vector<int> result;
+        for (auto& field: fields) {
+            auto it = std::find(header_.begin(), header_.end(), field);
+            if (it == header_.end())
+                throw std::invalid_argument{"field not in header: " + field.name()};
+            result.push_back(static_cast<int>(it - header_.begin()));
+        }
+        return result;
+    };
+
+    for (auto& fd: fds) {
+        auto lhs = columns_of(fd.first);
+        auto rhs = columns_of(fd.second);
+        checks_.push_back(Check{fd, lhs, rhs, detail::TupleIndex{static_cast<int>(lhs.size())}, {}});
+    }
+}
+
+void FDValidator::check_row(const std::int32_t *codes, FDSet& newly_violated) {
+    for (auto& check: checks_) {
+        if (check.violated)
+            continue;
+
+        key_.clear();
+        for (auto c: check.lhs) {
+            key_.push_back(codes[c]);
+        }
+        bool inserted;
+        auto entry = check.index.insert(key_.data(), inserted);
+
+        auto width = check.rhs.size();
+        if (inserted) {
+            for (auto c: check.rhs) {
+                check.rhs_values.push_back(codes[c]);
+            }
+            continue;
+        }
+
+        auto values = check.rhs_values.begin() + entry * width;
+        for (std::size_t i = 0; i < width; i++) {
+            if (values[i] != codes[check.rhs[i]]) {
+                check.violated = true;
+                check.index = detail::TupleIndex{0};
+                check.rhs_values = {};
+                violated_.insert(check.fd);
+                newly_violated.insert(check.fd);
+                break;
+            }
+        }
+    }
+    row_count_++;
+}
+
+FDSet FDValidator::append(const std::vector<std::vector<std::string>>& rows) {
+    for (auto& row: rows) {
+        if (row.size() != header_.size())
+            throw std::invalid_argument{"row of " + std::to_string(row.size()) + 
+                " values for " + std::to_string(header_.size()) + " fields"};
+    }
+
+    FDSet result;
+    for (auto& row: rows) {
+        for (std::size_t c = 0; c < header_.size(); c++) {
+            codes_[c] = dictionaries_[c].encode(row[c].data(), row[c].size());
+        }
+        check_row(codes_.data(), result);
+    }
+    return result;
+}
+
+FDSet FDValidator::append(const Dataset& batch) {
+    // Translate every distinct value of the batch once
+    std::vector<int> column_of(header_.size());
+    std::vector<std::vector<std::int32_t>> translated(header_.size());
+    for (std::size_t c = 0; c < header_.size(); c++) {
+        auto& batch_header = batch.header();
+        auto it = std::find(batch_header.begin(), batch_header.end(), header_[c]);
+        if (it == batch_header.end())
+            throw std::invalid_argument{"field not in batch: " + header_[c].name()};
+        column_of[c] = static_cast<int>(it - batch_header.begin());
+
+        for (std::int32_t code = 0; code < batch.distinct_count(column_of[c]); code++) {
+            auto& value = batch.value(column_of[c], code);
+            translated[c].push_back(dictionaries_[c].encode(value.data(), value.size()));
+        }
+    }
+
+    FDSet result;
+    for (int r = 0; r < batch.row_count(); r++) {
+        for (std::size_t c = 0; c < header_.size(); c++) {
+            codes_[c] = translated[c][batch.column(column_of[c])[r]];
+        }
+        check_row(codes_.data(), result);
+    }
+    return result;
+}
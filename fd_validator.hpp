@@ -0,0 +1,93 @@
+#ifndef DB_FD_VALIDATOR_HPP
+#define DB_FD_VALIDATOR_HPP
+
+#include "dataset.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace detail {
+
+// Hash set of fixed-width int32 tuples stored back to back.
+// Entries are numbered in insertion order.
+class TupleIndex {
+private:
+    int width_;
+    std::vector<std::int32_t> keys_;
+    // Open addressing over entries, -1 is a free slot
+    std::vector<std::int32_t> slots_;
+
+    std::size_t hash(const std::int32_t *key) const;
+
+    void grow();
+
+public:
+    explicit TupleIndex(int width): width_{width} {}
+
+    int size() const {
+        return width_ == 0 ? static_cast<int>(slots_.size() != 0) 
+            : static_cast<int>(keys_.size()) / width_;
+    }
+
+    // Entry of key, added when absent; inserted tells which.
+    std::int32_t insert(const std::int32_t *key, bool& inserted);
+};
+
+} // namespace detail
+
+// Checks the rows of a growing table against a set of FDs.
+// For every FD it keeps an index from the LHS values seen so far to the
+// RHS values that came with them, so a batch is checked in time linear
+// in its size. Once violated, an FD is reported and no longer indexed.
+class FDValidator {
+private:
+    struct Check {
+        FD fd;
+        std::vector<int> lhs;
+        std::vector<int> rhs;
+        detail::TupleIndex index;
+        // RHS values of every index entry, back to back
+        std::vector<std::int32_t> rhs_values;
+        bool violated = false;
+    };
+
+    std::vector<Field> header_;
+    std::vector<detail::Dictionary> dictionaries_;
+    std::vector<Check> checks_;
+    FDSet violated_;
+    std::size_t row_count_ = 0;
+    std::vector<std::int32_t> key_;
+    std::vector<std::int32_t> codes_;
+
+    void check_row(const std::int32_t *codes, FDSet& newly_violated);
+
+public:
+    // Rows have one value per header field. Throws std::invalid_argument
+    // when an FD uses a field that is not in the header.
+    FDValidator(const FDSet& fds, std::vector<Field> header);
+
+    const std::vector<Field>& header() const {
+        return header_;
+    }
+
+    std::size_t row_count() const {
+        return row_count_;
+    }
+
+    // Every FD violated by the rows appended so far
+    const FDSet& violated() const {
+        return violated_;
+    }
+
+    // Appends rows and returns the FDs they violate for the first time.
+    // Every row has one value per header field, in header order. Throws
+    // std::invalid_argument, before appending any row, when one does not.
+    FDSet append(const std::vector<std::vector<std::string>>& rows);
+
+    // Same for a batch whose header has the fields of header(),
+    // in any order.
+    FDSet append(const Dataset& batch);
+};
+
+#endif
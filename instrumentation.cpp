@@ -0,0 +1,160 @@
+#include "instrumentation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char *name;
+    std::int64_t start;
+    std::int64_t duration;
+    int thread;
+};
+
+struct Recorder {
+    std::atomic<std::uint64_t> counters[static_cast<int>(detail::Counter::count)] = {};
+    std::atomic<bool> tracing{false};
+
+    std::mutex mutex;
+    std::map<std::string, PhaseStats> phases;
+    std::vector<TraceEvent> events;
+    std::unordered_map<std::thread::id, int> threads;
+};
+
+Recorder& recorder() {
+    static Recorder instance;
+    return instance;
+}
+
+std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::uint64_t counter(detail::Counter c) {
+    return recorder().counters[static_cast<int>(c)].load(std::memory_order_relaxed);
+}
+
+void write_json_string(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (char ch: s) {
+        if (ch == '"' || ch == '\\')
+            out << '\\';
+        out << ch;
+    }
+    out << '"';
+}
+
+} // namespace
+
+AlgorithmStats algorithm_stats() {
+    using detail::Counter;
+    AlgorithmStats result;
+    if (!instrumentation_enabled)
+        return result;
+
+    result.closure_calls = counter(Counter::closure_calls);
+    result.fds_scanned = counter(Counter::fds_scanned);
+    result.fixpoint_iterations = counter(Counter::fixpoint_iterations);
+    result.chase_rounds = counter(Counter::chase_rounds);
+    result.row_comparisons = counter(Counter::row_comparisons);
+    result.set_allocations = counter(Counter::set_allocations);
+    result.field_set_allocations = counter(Counter::field_set_allocations);
+    result.sample_rejections = counter(Counter::sample_rejections);
+
+    auto& r = recorder();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    result.phases = r.phases;
+    return result;
+}
+
+void reset_algorithm_stats() {
+    auto& r = recorder();
+    for (auto& c: r.counters) {
+        c.store(0, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock{r.mutex};
+    r.phases.clear();
+}
+
+void start_trace() {
+    auto& r = recorder();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    r.events.clear();
+    r.tracing.store(true);
+}
+
+void stop_trace() {
+    recorder().tracing.store(false);
+}
+
+void write_chrome_trace(std::ostream& out) {
+    auto stats = algorithm_stats();
+    auto& r = recorder();
+    std::lock_guard<std::mutex> lock{r.mutex};
+
+    // Timestamps in microseconds from the first event
+    std::int64_t origin = r.events.empty() ? 0 : r.events.front().start;
+    std::int64_t end = origin;
+    for (auto& e: r.events) {
+        origin = std::min(origin, e.start);
+        end = std::max(end, e.start + e.duration);
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (auto& e: r.events) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"name\":";
+        write_json_string(out, e.name);
+        out << ",\"cat\":\"fd\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+            << ",\"ts\":" << (e.start - origin) / 1000.0
+            << ",\"dur\":" << e.duration / 1000.0 << "}";
+    }
+
+    if (instrumentation_enabled) {
+        out << (first ? "\n" : ",\n");
+        out << "{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":"
+            << (end - origin) / 1000.0 << ",\"args\":{"
+            << "\"closure_calls\":" << stats.closure_calls
+            << ",\"fds_scanned\":" << stats.fds_scanned
+            << ",\"fixpoint_iterations\":" << stats.fixpoint_iterations
+            << ",\"chase_rounds\":" << stats.chase_rounds
+            << ",\"row_comparisons\":" << stats.row_comparisons
+            << ",\"set_allocations\":" << stats.set_allocations
+            << ",\"field_set_allocations\":" << stats.field_set_allocations
+            << ",\"sample_rejections\":" << stats.sample_rejections << "}}";
+    }
+    out << "\n]}\n";
+}
+
+namespace detail {
+
+void add_count(Counter counter, std::uint64_t n) {
+    recorder().counters[static_cast<int>(counter)].fetch_add(n, std::memory_order_relaxed);
+}
+
+PhaseTimer::PhaseTimer(const char *name): name_{name}, start_{now()} {}
+
+PhaseTimer::~PhaseTimer() {
+    std::int64_t duration = now() - start_;
+    auto& r = recorder();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    auto& phase = r.phases[name_];
+    phase.calls++;
+    phase.nanoseconds += duration;
+
+    if (r.tracing.load()) {
+        auto inserted = r.threads.emplace(std::this_thread::get_id(),
+                static_cast<int>(r.threads.size()));
+        r.events.push_back(TraceEvent{name_, start_, duration, inserted.first->second});
+    }
+}
+
+} // namespace detail
@@ -0,0 +1,112 @@
+#ifndef DB_INSTRUMENTATION_HPP
+#define DB_INSTRUMENTATION_HPP
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+// Counters and phase timers of the FD algorithms.
+// They are compiled in only with DB_INSTRUMENTATION defined (the CMake
+// option of the same name). Without it DB_COUNT and DB_PHASE expand to
+// nothing, their arguments are not evaluated, and the functions below
+// report nothing.
+// Counters are process-wide relaxed atomics, so they add up the work of
+// every thread. Phase times are inclusive of nested phases.
+
+#ifdef DB_INSTRUMENTATION
+constexpr bool instrumentation_enabled = true;
+#else
+constexpr bool instrumentation_enabled = false;
+#endif
+
+struct PhaseStats {
+    std::uint64_t calls = 0;
+    std::uint64_t nanoseconds = 0;
+};
+
+struct AlgorithmStats {
+    std::uint64_t closure_calls = 0;
+    // FDs looked at by closures: index entries visited by ClosureEngine,
+    // FDs tested by the FieldSet closure_of
+    std::uint64_t fds_scanned = 0;
+    // Passes over the FD set of the FieldSet closure_of
+    std::uint64_t fixpoint_iterations = 0;
+    // Passes over the FD set of the chase
+    std::uint64_t chase_rounds = 0;
+    // Pairs of tableau rows compared on an LHS
+    std::uint64_t row_comparisons = 0;
+    // AttributeSets that allocated their words
+    std::uint64_t set_allocations = 0;
+    // FieldSets of closure_of and convert_3nf that got members, each
+    // counted once. A std::set allocates a node per member, not counted.
+    // The FieldSets of the functions they call are not counted.
+    std::uint64_t field_set_allocations = 0;
+    // Approximate FD candidates rejected on the row sample
+    std::uint64_t sample_rejections = 0;
+    std::map<std::string, PhaseStats> phases;
+};
+
+AlgorithmStats algorithm_stats();
+
+void reset_algorithm_stats();
+
+// While tracing, every phase is also kept as an event for
+// write_chrome_trace. Starting drops the events kept so far.
+void start_trace();
+
+void stop_trace();
+
+// Writes the kept events in the Chrome trace event format, for
+// chrome://tracing or Perfetto, with the counters as a final counter event.
+void write_chrome_trace(std::ostream& out);
+
+namespace detail {
+
+enum class Counter {
+    closure_calls,
+    fds_scanned,
+    fixpoint_iterations,
+    chase_rounds,
+    row_comparisons,
+    set_allocations,
+    field_set_allocations,
+    sample_rejections,
+    count
+};
+
+void add_count(Counter counter, std::uint64_t n);
+
+// Adds the time from construction to destruction to a phase
+class PhaseTimer {
+private:
+    const char *name_;
+    std::int64_t start_;
+
+public:
+    explicit PhaseTimer(const char *name);
+
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer&) = delete;
+
+    PhaseTimer& operator = (const PhaseTimer&) = delete;
+};
+
+} // namespace detail
+
+#define DB_CONCAT_IMPL(a, b) a##b
+#define DB_CONCAT(a, b) DB_CONCAT_IMPL(a, b)
+
+#ifdef DB_INSTRUMENTATION
+#define DB_COUNT(counter, n) \
+    ::detail::add_count(::detail::Counter::counter, static_cast<std::uint64_t>(n))
+// Times the rest of the enclosing scope
+#define DB_PHASE(name) \
+    ::detail::PhaseTimer DB_CONCAT(db_phase_, __LINE__){name}
+#else
+#define DB_COUNT(counter, n) ((void)0)
+#define DB_PHASE(name) ((void)0)
+#endif
+
+#endif
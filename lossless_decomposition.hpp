@@ -2,8 +2,10 @@
 #define LOSSLESS_DECOMPOSTITION_HPP
 
 #include "util.hpp"
+#include "attribute_set.hpp"
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 
 namespace detail {
 
@@ -33,6 +35,107 @@ bool row_homogenize(const TableHeader& header,
 void init_table(Table& table, const TableHeader& header, 
                 const std::vector<FieldSet>& relation_list);
 
+// Chase tableau keeping a union-find over the symbols of each column.
+// In every column, symbol r is the nondistinguished symbol of row r and
+// symbol row_count() is the distinguished one, always a root.
+class ChaseTableau {
+private:
+    int row_count_;
+    int column_count_;
+    std::vector<int> parent_;
+
+    std::vector<int> lhs_;
+    std::vector<int> rhs_;
+    std::vector<int> keys_;
+    std::vector<int> slots_;
+
+    int *parents_of(int column) {
+        return parent_.data() + column * (row_count_ + 1);
+    }
+
+public:
+    ChaseTableau(int column_count, const std::vector<AttributeSet>& relations);
+
+    int row_count() const {
+        return row_count_;
+    }
+
+    int distinguished() const {
+        return row_count_;
+    }
+
+    int symbol(int row, int column);
+
+    // Applies X -> Y once: rows are grouped by hashing their symbols on X,
+    // then the Y symbols of each group are merged.
+    bool apply(const AttributeFD& fd);
+
+    bool has_distinguished_row();
+};
+
+// Chase tableau stored column-major as a distinguished-bit plane and
+// a symbol plane. Applying X -> Y hashes the X columns of all rows at
+// once, then rows equal to a given row on X are found with a vectorized
+// compare over each column. AVX2 is used when the CPU has it.
+// Equating two symbols renames the symbol in the whole column.
+class PackedTableau {
+public:
+    using Word = std::uint64_t;
+    static constexpr std::int32_t distinguished_symbol = -1;
+
+private:
+    int row_count_;
+    int column_count_;
+    int stride_;
+    int word_count_;
+
+    std::vector<std::int32_t> symbols_;
+    std::vector<Word> distinguished_;
+
+    std::vector<Word> valid_;
+    std::vector<Word> match_;
+    std::vector<Word> processed_;
+    std::vector<std::uint32_t> hashes_;
+    std::vector<int> slots_;
+    std::vector<int> lhs_;
+    std::vector<int> rhs_;
+
+    std::int32_t *column(int c) {
+        return symbols_.data() + c * stride_;
+    }
+
+    Word *distinguished_plane(int c) {
+        return distinguished_.data() + c * word_count_;
+    }
+
+    void rename(int c, std::int32_t from, std::int32_t to);
+
+public:
+    PackedTableau(int column_count, const std::vector<AttributeSet>& relations);
+
+    int row_count() const {
+        return row_count_;
+    }
+
+    std::int32_t symbol(int row, int c) const {
+        return symbols_[c * stride_ + row];
+    }
+
+    bool is_distinguished(int row, int c) const {
+        return (distinguished_[c * word_count_ + row / 64] >> (row % 64)) & 1;
+    }
+
+    // Bit mask of the rows with the same symbols as row on columns
+    const std::vector<Word>& match_rows(int row, const std::vector<int>& columns);
+
+    bool apply(const AttributeFD& fd);
+
+    bool has_distinguished_row() const;
+};
+
+// Whether is_lossless_decomposition chases on a PackedTableau
+bool use_packed_tableau(int row_count);
+
 } // namespace detail
 
 bool is_lossless_decomposition(const FieldSet& U, const FDSet& F, 
@@ -0,0 +1,43 @@
+#include "mapped_file.hpp"
+#include <cerrno>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace detail {
+
+File::File(const std::string& path): fd_{::open(path.c_str(), O_RDONLY)}, path_{path} {
+    if (fd_ == -1)
+        throw std::system_error{errno, std::generic_category(), path};
+}
+
+File::~File() {
+    ::close(fd_);
+}
+
+std::size_t File::size() const {
+    struct stat status;
+    if (::fstat(fd_, &status) == -1)
+        throw std::system_error{errno, std::generic_category(), path_};
+    return static_cast<std::size_t>(status.st_size);
+}
+
+Mapping::Mapping(const File& file, std::size_t offset, std::size_t size)
+    : data_{::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.fd(), static_cast<off_t>(offset))},
+    size_{size} {
+    if (data_ == MAP_FAILED)
+        throw std::system_error{errno, std::generic_category(), file.path()};
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+}
+
+Mapping::~Mapping() {
+    ::munmap(data_, size_);
+}
+
+std::size_t page_size() {
+    return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+} // namespace detail
@@ -0,0 +1,65 @@
+#ifndef DB_MAPPED_FILE_HPP
+#define DB_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace detail {
+
+// Read-only file descriptor, throws std::system_error naming the path
+// when the file cannot be opened or queried.
+class File {
+private:
+    int fd_;
+    std::string path_;
+
+public:
+    explicit File(const std::string& path);
+
+    ~File();
+
+    File(const File&) = delete;
+
+    File& operator = (const File&) = delete;
+
+    int fd() const {
+        return fd_;
+    }
+
+    const std::string& path() const {
+        return path_;
+    }
+
+    std::size_t size() const;
+};
+
+// Private read-only mapping of size bytes of file from offset, which must
+// be a multiple of page_size(). Advised for sequential reads.
+class Mapping {
+private:
+    void *data_;
+    std::size_t size_;
+
+public:
+    Mapping(const File& file, std::size_t offset, std::size_t size);
+
+    ~Mapping();
+
+    Mapping(const Mapping&) = delete;
+
+    Mapping& operator = (const Mapping&) = delete;
+
+    const char *data() const {
+        return static_cast<const char *>(data_);
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+};
+
+std::size_t page_size();
+
+} // namespace detail
+
+#endif
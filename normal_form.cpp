@@ -1,23 +1,35 @@
 #include "normal_form.hpp"
 #include "lossless_decomposition.hpp"
+#include "closure_engine.hpp"
+#include "instrumentation.hpp"
 #include <map>
 
 std::vector<FieldSet> convert_3nf(const FieldSet& U, const FDSet& F) {
+    DB_PHASE("convert_3nf");
     std::vector<FieldSet> result;
-    auto remain_fields = U - field_set_from(F);
+    auto fields = field_set_from(F);
+    // U - fields starts from a copy of U
+    auto remain_fields = U - fields;
+    DB_COUNT(field_set_allocations, !fields.empty() + !U.empty());
 
     std::map<FieldSet, FieldSet> relations;
 
     for (auto& fd: F) {
-        relations[fd.first] += fd.second;
+        auto inserted = relations.emplace(fd.first, FieldSet{});
+        auto& rhs = inserted.first->second;
+        DB_COUNT(field_set_allocations, 
+                (inserted.second && !fd.first.empty()) + (rhs.empty() && !fd.second.empty()));
+        rhs += fd.second;
     }
 
     for (auto& e: relations) {
+        DB_COUNT(field_set_allocations, !e.first.empty() || !e.second.empty());
         result.push_back(e.first + e.second);
     }
 
     bool lossless = is_lossless_decomposition(U, F, result);
     if (!lossless) {
+        DB_COUNT(field_set_allocations, remain_fields.empty());
         remain_fields += candidate_key(U, F);
         result.push_back(remain_fields);
     }
@@ -27,3 +39,308 @@ std::vector<FieldSet> convert_3nf(const FieldSet& U, const FDSet& F) {
     
     return result;
 }
+
+namespace {
+
+// Relations up to this size that the pair test can not certify
+// are checked on every attribute subset.
+const int exhaustive_bcnf_limit = 12;
+
+struct BCNFSearch {
+    ClosureEngine& engine;
+    const AttributeFDSet& F;
+    AttributeSet closure;
+    AttributeSet X;
+
+    // X -> cl(X) * R violates BCNF in R when it is neither trivial nor
+    // makes X a superkey of R
+    bool violates(const AttributeSet& R, const AttributeSet& lhs) {
+        engine.closure(lhs, closure);
+        closure &= R;
+        return closure != R && closure != lhs;
+    }
+
+    // Drops attributes from the violating X while it still violates,
+    // so that R splits into small relations
+    void minimize_violation(const AttributeSet& R) {
+        AttributeSet lhs = X;
+        X.for_each([&](int id) {
+            lhs.erase(id);
+            if (!violates(R, lhs))
+                lhs.insert(id);
+        });
+        X = lhs;
+    }
+
+    // FDs of F inside R
+    bool find_direct(const AttributeSet& R) {
+        for (auto& fd: F) {
+            if (fd.first.empty() || !is_subset(fd.first, R))
+                continue;
+            if (is_subset(fd.second * R, fd.first))
+                continue;
+            if (violates(R, fd.first)) {
+                X = fd.first;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Looks for A, B with A in cl(R - AB). When B is not in that closure
+    // too, R - AB is a violation. Sets pair_found when only pairs with
+    // superkeys R - AB were seen: R may or may not be in BCNF then.
+    // Without any pair, R is in BCNF.
+    bool find_by_pairs(const AttributeSet& R, bool& pair_found) {
+        pair_found = false;
+        bool found = false;
+        AttributeSet rest = R;
+        R.for_each([&](int a) {
+            if (found)
+                return;
+            rest.erase(a);
+            engine.closure(rest, closure);
+            if (closure.contains(a)) {
+                R.for_each([&](int b) {
+                    if (found || b == a)
+                        return;
+                    rest.erase(b);
+                    engine.closure(rest, closure);
+                    if (closure.contains(a)) {
+                        pair_found = true;
+                        if (!closure.contains(b)) {
+                            X = rest;
+                            found = true;
+                        }
+                    }
+                    rest.insert(b);
+                });
+            }
+            rest.insert(a);
+        });
+        return found;
+    }
+
+    bool find_exhaustive(const AttributeSet& R) {
+        std::vector<int> ids;
+        R.for_each([&ids](int id) { ids.push_back(id); });
+
+        AttributeSet lhs(R.universe_size());
+        for (int mask = 1; mask + 1 < (1 << ids.size()); mask++) {
+            lhs.clear();
+            for (size_t k = 0; k < ids.size(); k++) {
+                if (mask & (1 << k))
+                    lhs.insert(ids[k]);
+            }
+            if (violates(R, lhs)) {
+                X = lhs;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Tsou-Fischer: shrinks R to a BCNF subschema Y = (Y - A) A
+    // with Y - A -> A, so that R splits losslessly into Y and R - A.
+    AttributeSet extract(const AttributeSet& R, int& A) {
+        AttributeSet Y = R;
+        AttributeSet rest;
+        bool shrunk = true;
+        while (shrunk) {
+            shrunk = false;
+            Y.for_each([&](int a) {
+                if (shrunk)
+                    return;
+                Y.for_each([&](int b) {
+                    if (shrunk || b == a)
+                        return;
+                    rest = Y;
+                    rest.erase(a);
+                    rest.erase(b);
+                    engine.closure(rest, closure);
+                    if (closure.contains(a)) {
+                        A = a;
+                        Y.erase(b);
+                        shrunk = true;
+                    }
+                });
+            });
+        }
+        return Y;
+    }
+};
+
+// Restricted closure of X over the relations: X grows with
+// cl(X * R) * R for every relation R until nothing changes.
+// A relation is skipped while X * R is the same as on its last visit.
+class DependencyChecker {
+private:
+    ClosureEngine& engine_;
+    const std::vector<AttributeSet>& relations_;
+    AttributeSet Z_;
+    AttributeSet part_;
+    AttributeSet closure_;
+    std::vector<int> seen_;
+
+public:
+    DependencyChecker(ClosureEngine& engine, const std::vector<AttributeSet>& relations)
+        : engine_{engine}, relations_{relations}, seen_(relations.size()) {}
+
+    bool preserved(const AttributeFD& fd) {
+        for (auto& R: relations_) {
+            if (is_subset(fd.first, R) && is_subset(fd.second, R))
+                return true;
+        }
+
+        Z_ = fd.first;
+        std::fill(seen_.begin(), seen_.end(), -1);
+        bool changed = true;
+        while (changed && !is_subset(fd.second, Z_)) {
+            changed = false;
+            for (size_t i = 0; i < relations_.size(); i++) {
+                auto& R = relations_[i];
+                int common = Z_.intersection_size(R);
+                if (common == seen_[i])
+                    continue;
+                seen_[i] = common;
+
+                part_ = Z_;
+                part_ &= R;
+                engine_.closure(part_, closure_);
+                closure_ &= R;
+                if (!is_subset(closure_, Z_)) {
+                    Z_ |= closure_;
+                    changed = true;
+                }
+            }
+        }
+        return is_subset(fd.second, Z_);
+    }
+};
+
+} // namespace
+
+// Relations are split on violations found with closures on the bitset
+// engine, never by projecting F:
+// 1. FDs of F whose LHS is inside the relation,
+// 2. the pair test of Tsou and Fischer, O(|R|^2) closures,
+// 3. every attribute subset, for small relations the pair test can not
+//    certify,
+// 4. otherwise Tsou-Fischer extraction, which always gives BCNF
+//    relations but may split more than needed.
+std::vector<AttributeSet> convert_bcnf(const AttributeSet& U, 
+        const AttributeFDSet& F, AttributeFDSet& lost_fds) {
+    DB_PHASE("convert_bcnf");
+    ClosureEngine engine{F};
+    BCNFSearch search{engine, F, AttributeSet(U.universe_size()), 
+        AttributeSet(U.universe_size())};
+
+    std::vector<AttributeSet> result;
+    std::vector<AttributeSet> pending{U};
+    {
+        DB_PHASE("convert_bcnf/split");
+        while (!pending.empty()) {
+            AttributeSet R = std::move(pending.back());
+            pending.pop_back();
+
+            if (R.size() <= 2) {
+                result.push_back(R);
+                continue;
+            }
+
+            bool pair_found = false;
+            bool found = search.find_direct(R) || search.find_by_pairs(R, pair_found);
+            if (!found && pair_found && R.size() <= exhaustive_bcnf_limit)
+                found = search.find_exhaustive(R);
+
+            if (found) {
+                search.minimize_violation(R);
+                engine.closure(search.X, search.closure);
+                AttributeSet C = search.closure * R;
+                pending.push_back(search.X + (R - C));
+                pending.push_back(C);
+            }
+            else if (pair_found && R.size() > exhaustive_bcnf_limit) {
+                int A = -1;
+                result.push_back(search.extract(R, A));
+                R.erase(A);
+                pending.push_back(R);
+            }
+            else {
+                result.push_back(R);
+            }
+        }
+    }
+
+    // A relation inside another one adds nothing to the join
+    std::sort(result.begin(), result.end(), 
+            [](const AttributeSet& R1, const AttributeSet& R2) {
+        return R1.size() > R2.size() || (R1.size() == R2.size() && R1 < R2);
+    });
+    std::vector<AttributeSet> relations;
+    for (auto& R: result) {
+        bool subsumed = std::any_of(relations.begin(), relations.end(), 
+                [&R](const AttributeSet& other) { return is_subset(R, other); });
+        if (!subsumed)
+            relations.push_back(std::move(R));
+    }
+
+    DB_PHASE("convert_bcnf/preservation");
+    DependencyChecker checker{engine, relations};
+    for (auto& fd: F) {
+        if (!fd.first.empty() && !checker.preserved(fd))
+            lost_fds.push_back(fd);
+    }
+    return relations;
+}
+
+std::vector<FieldSet> convert_bcnf(const FieldSet& U, const FDSet& F, FDSet& lost_fds) {
+    Schema schema{U + field_set_from(F)};
+    AttributeFDSet lost;
+    auto relations = convert_bcnf(schema.encode(U), schema.encode(F), lost);
+
+    std::vector<FieldSet> result;
+    for (auto& R: relations) {
+        result.push_back(schema.decode(R));
+    }
+    lost_fds += schema.decode(lost);
+    return result;
+}
+
+std::vector<FieldSet> convert_bcnf(const FieldSet& U, const FDSet& F) {
+    FDSet lost_fds;
+    return convert_bcnf(U, F, lost_fds);
+}
+
+bool is_dependency_preserving(const AttributeFDSet& F, 
+        const std::vector<AttributeSet>& relations) {
+    auto contained = [&relations](const AttributeFD& fd) {
+        return std::any_of(relations.begin(), relations.end(), 
+                [&fd](const AttributeSet& R) {
+            return is_subset(fd.first, R) && is_subset(fd.second, R);
+        });
+    };
+    if (std::all_of(F.begin(), F.end(), contained))
+        return true;
+
+    DB_PHASE("is_dependency_preserving");
+    ClosureEngine engine{F};
+    DependencyChecker checker{engine, relations};
+    return std::all_of(F.begin(), F.end(), [&checker](const AttributeFD& fd) {
+        return fd.first.empty() || checker.preserved(fd);
+    });
+}
+
+bool is_dependency_preserving(const FDSet& F, const std::vector<FieldSet>& relations) {
+    FieldSet U = field_set_from(F);
+    for (auto& R: relations) {
+        U += R;
+    }
+    Schema schema{U};
+
+    std::vector<AttributeSet> encoded;
+    for (auto& R: relations) {
+        encoded.push_back(schema.encode(R));
+    }
+    return is_dependency_preserving(schema.encode(F), encoded);
+}
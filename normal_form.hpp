@@ -6,4 +6,20 @@
 
 std::vector<FieldSet> convert_3nf(const FieldSet& U, const FDSet& F);
 
+// Lossless decomposition of U into BCNF relations.
+// FDs of F not preserved by the decomposition are added to lost_fds.
+std::vector<FieldSet> convert_bcnf(const FieldSet& U, const FDSet& F, FDSet& lost_fds);
+
+std::vector<FieldSet> convert_bcnf(const FieldSet& U, const FDSet& F);
+
+std::vector<AttributeSet> convert_bcnf(const AttributeSet& U, 
+        const AttributeFDSet& F, AttributeFDSet& lost_fds);
+
+// Whether the relations preserve F, with the polynomial restricted
+// closure test. Returns at once when every FD lies inside a relation.
+bool is_dependency_preserving(const FDSet& F, const std::vector<FieldSet>& relations);
+
+bool is_dependency_preserving(const AttributeFDSet& F, 
+        const std::vector<AttributeSet>& relations);
+
 #endif
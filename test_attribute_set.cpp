@@ -0,0 +1,76 @@
+#include "attribute_set.hpp"
+#include <gmock/gmock.h>
+
+const Field A = "A";
+const Field B = "B";
+const Field C = "C";
+const Field D = "D";
+const Field E = "E";
+
+TEST(attribute_set, insert_erase_contains) {
+    AttributeSet set(130);
+    set.insert(0);
+    set.insert(64);
+    set.insert(129);
+    ASSERT_EQ(set.size(), 3);
+    ASSERT_TRUE(set.contains(64));
+    ASSERT_FALSE(set.contains(65));
+
+    set.erase(64);
+    ASSERT_EQ(set.size(), 2);
+    ASSERT_FALSE(set.contains(64));
+
+    std::vector<int> ids;
+    set.for_each([&ids](int id) { ids.push_back(id); });
+    ASSERT_EQ(ids, (std::vector<int>{0, 129}));
+}
+
+TEST(attribute_set, operators) {
+    AttributeSet set1(70), set2(70);
+    set1.insert(1);
+    set1.insert(69);
+    set2.insert(69);
+    set2.insert(3);
+
+    auto sum = set1 + set2;
+    ASSERT_EQ(sum.size(), 3);
+    ASSERT_EQ(set1 - set2, [] { AttributeSet s(70); s.insert(1); return s; }());
+    ASSERT_EQ((set1 * set2).size(), 1);
+    ASSERT_TRUE(is_subset(set1, sum));
+    ASSERT_FALSE(is_subset(sum, set1));
+    ASSERT_TRUE(set1.intersects(set2));
+}
+
+TEST(attribute_set, order_same_as_field_set) {
+    Schema schema{make_set(A, B, C, D, E)};
+    std::vector<FieldSet> sets{
+        make_set(A), make_set(A, B), make_set(A, C), make_set(B),
+        make_set(B, C, D), make_set(B, D), make_set(E), FieldSet{}
+    };
+
+    for (auto& s1: sets) {
+        for (auto& s2: sets) {
+            ASSERT_EQ(s1 < s2, schema.encode(s1) < schema.encode(s2));
+        }
+    }
+}
+
+TEST(schema, encode_decode) {
+    Schema schema{make_set(A, B, C, D)};
+    ASSERT_EQ(schema.size(), 4);
+    ASSERT_EQ(schema.id_of(A), 0);
+    ASSERT_EQ(schema.id_of(D), 3);
+    ASSERT_EQ(schema.id_of(E), -1);
+    ASSERT_EQ(schema.field_of(2), C);
+
+    auto set = schema.encode(make_set(B, D));
+    ASSERT_TRUE(set.contains(1));
+    ASSERT_TRUE(set.contains(3));
+    ASSERT_EQ(schema.decode(set), make_set(B, D));
+
+    auto fds = make_set(
+            make_FD(make_set(A, B), C),
+            make_FD(D, make_set(A, C))
+    );
+    ASSERT_EQ(schema.decode(schema.encode(fds)), fds);
+}
@@ -0,0 +1,139 @@
+#include "closure_cache.hpp"
+#include "fd_algorithm.hpp"
+#include "thread_pool.hpp"
+#include <gmock/gmock.h>
+
+const Field A = "A";
+const Field B = "B";
+const Field C = "C";
+const Field D = "D";
+const Field E = "E";
+const Field F = "F";
+
+TEST(closure_cache, hit_and_miss) {
+    auto fds = make_set(
+            make_FD(make_set(A, B), C),
+            make_FD(C, D)
+    );
+    Schema schema{make_set(A, B, C, D, E)};
+    ClosureEngine engine{schema.encode(fds)};
+    ClosureCache cache;
+
+    auto AB = schema.encode(make_set(A, B));
+    ASSERT_EQ(schema.decode(cache.closure(engine, AB)), make_set(A, B, C, D));
+    ASSERT_EQ(cache.hits(), 0u);
+    ASSERT_EQ(cache.misses(), 1u);
+
+    ASSERT_EQ(schema.decode(cache.closure(engine, AB)), make_set(A, B, C, D));
+    ASSERT_EQ(cache.hits(), 1u);
+    ASSERT_EQ(cache.size(), 1u);
+
+    // AB determines C: ABC is answered from AB
+    auto ABC = schema.encode(make_set(A, B, C));
+    ASSERT_EQ(schema.decode(cache.closure(engine, ABC)), make_set(A, B, C, D));
+    ASSERT_EQ(cache.hits(), 2u);
+    ASSERT_EQ(cache.size(), 2u);
+
+    // AB does not determine E
+    auto ABE = schema.encode(make_set(A, B, E));
+    ASSERT_EQ(schema.decode(cache.closure(engine, ABE)), make_set(A, B, C, D, E));
+    ASSERT_EQ(cache.misses(), 2u);
+
+    cache.clear();
+    ASSERT_EQ(cache.size(), 0u);
+    ASSERT_EQ(cache.hits(), 0u);
+    AttributeSet closure;
+    ASSERT_FALSE(cache.find(AB, closure));
+}
+
+TEST(closure_cache, bounded) {
+    Schema schema{make_set(A, B, C, D, E, F)};
+    ClosureEngine engine{schema.encode(make_set(make_FD(A, B)))};
+    ClosureCache cache{16};
+
+    for (int mask = 0; mask < 64; mask++) {
+        AttributeSet set = schema.empty_set();
+        for (int id = 0; id < 6; id++) {
+            if (mask & (1 << id))
+                set.insert(id);
+        }
+        cache.closure(engine, set);
+        ASSERT_LE(cache.size(), 16u);
+    }
+
+    // The most recent entry survives
+    AttributeSet closure;
+    ASSERT_TRUE(cache.find(schema.all(), closure));
+    ASSERT_EQ(closure, schema.all());
+}
+
+TEST(closure_cache, algorithms) {
+    const std::vector<Field> fields{A, B, C, D, E, F};
+    unsigned seed = 23;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    Schema schema{make_set(A, B, C, D, E, F)};
+    for (int round = 0; round < 30; round++) {
+        FDSet fds;
+        for (int i = 0; i < 6; i++) {
+            FieldSet X, Y;
+            for (int k = 0; k < 3; k++)
+                X.insert(fields[next() % fields.size()]);
+            Y.insert(fields[next() % fields.size()]);
+            fds.insert(make_FD(X, Y));
+        }
+        auto encoded = schema.encode(fds);
+
+        ClosureCache cache{64};
+        ASSERT_EQ(minimal_cover(encoded, cache), minimal_cover(encoded));
+
+        std::vector<AttributeSet> keys, cached_keys;
+        all_candidate_keys(schema.all(), encoded, [&keys](const AttributeSet& key) {
+            keys.push_back(key);
+            return true;
+        });
+        all_candidate_keys(schema.all(), encoded, [&cached_keys](const AttributeSet& key) {
+            cached_keys.push_back(key);
+            return true;
+        }, cache);
+        ASSERT_EQ(cached_keys, keys);
+    }
+}
+
+TEST(closure_cache, shared_by_threads) {
+    auto fds = make_set(
+            make_FD(make_set(A, B), C),
+            make_FD(make_set(C, E), F),
+            make_FD(D, A),
+            make_FD(F, make_set(B, D))
+    );
+    Schema schema{make_set(A, B, C, D, E, F)};
+    auto encoded = schema.encode(fds);
+    ClosureCache cache{32};
+
+    const int thread_count = 4;
+    ThreadPool pool{thread_count};
+    std::vector<ClosureEngine> engines(thread_count, ClosureEngine{encoded});
+    std::vector<AttributeSet> closures(1000);
+    pool.parallel_for(closures.size(), [&](int i, int worker) {
+        AttributeSet set = schema.empty_set();
+        for (int id = 0; id < 6; id++) {
+            if ((i * 7 + i / 64) & (1 << id))
+                set.insert(id);
+        }
+        closures[i] = cache.closure(engines[worker], set);
+    });
+
+    for (int i = 0; i < 1000; i++) {
+        AttributeSet set = schema.empty_set();
+        for (int id = 0; id < 6; id++) {
+            if ((i * 7 + i / 64) & (1 << id))
+                set.insert(id);
+        }
+        ASSERT_EQ(closures[i], closure_of(set, encoded));
+    }
+    ASSERT_EQ(cache.hits() + cache.misses(), 1000u);
+}
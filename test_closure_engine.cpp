@@ -0,0 +1,149 @@
+#include "closure_engine.hpp"
+#include "fd_algorithm.hpp"
+#include <gmock/gmock.h>
+
+const Field A = "A";
+const Field B = "B";
+const Field C = "C";
+const Field D = "D";
+const Field E = "E";
+const Field F = "F";
+
+TEST(closure_engine, closure) {
+    auto fds = make_set(
+            make_FD(make_set(A, B), C),
+            make_FD(make_set(B, C), make_set(A, D)),
+            make_FD(D, E),
+            make_FD(make_set(C, F), B)
+    );
+    Schema schema{make_set(A, B, C, D, E, F)};
+    ClosureEngine engine{schema.encode(fds)};
+
+    ASSERT_EQ(schema.decode(engine.closure(schema.encode(make_set(A, B)))), 
+            make_set(A, B, C, D, E));
+    ASSERT_EQ(schema.decode(engine.closure(schema.encode(make_set(C, F)))), 
+            make_set(A, B, C, D, E, F));
+    ASSERT_EQ(schema.decode(engine.closure(schema.encode(make_set(A)))), 
+            make_set(A));
+}
+
+TEST(closure_engine, disabled_fd) {
+    auto fds = make_set(
+            make_FD(A, B),
+            make_FD(B, C)
+    );
+    Schema schema{make_set(A, B, C)};
+    ClosureEngine engine{schema.encode(fds)};
+
+    engine.set_enabled(1, false);
+    ASSERT_EQ(schema.decode(engine.closure(schema.encode(make_set(A)))), 
+            make_set(A, B));
+    engine.set_enabled(1, true);
+    ASSERT_EQ(schema.decode(engine.closure(schema.encode(make_set(A)))), 
+            make_set(A, B, C));
+}
+
+TEST(closure_engine, same_as_reference_closure_of) {
+    const std::vector<Field> fields{A, B, C, D, E, F};
+    unsigned seed = 42;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    for (int round = 0; round < 50; round++) {
+        FDSet fds;
+        for (int i = 0; i < 6; i++) {
+            FieldSet X, Y;
+            for (int k = 0; k < 2; k++)
+                X.insert(fields[next() % fields.size()]);
+            for (int k = 0; k < 2; k++)
+                Y.insert(fields[next() % fields.size()]);
+            fds.insert(make_FD(X, Y));
+        }
+
+        Schema schema{make_set(A, B, C, D, E, F)};
+        ClosureEngine engine{schema.encode(fds)};
+        for (auto& field: fields) {
+            FieldSet X = make_set(field, fields[next() % fields.size()]);
+            ASSERT_EQ(schema.decode(engine.closure(schema.encode(X))), 
+                    closure_of(X, fds));
+        }
+    }
+}
+
+TEST(closure_engine, shrink_lhs) {
+    auto fds = make_set(
+            make_FD(make_set(A, B), C),
+            make_FD(C, D)
+    );
+    Schema schema{make_set(A, B, C, D)};
+    ClosureEngine engine{schema.encode(fds)};
+
+    ASSERT_EQ(schema.decode(engine.closure(schema.encode(make_set(A)))), 
+            make_set(A));
+
+    engine.shrink_lhs(0, schema.encode(make_set(A)));
+    ASSERT_EQ(schema.decode(engine.lhs(0)), make_set(A));
+    ASSERT_EQ(schema.decode(engine.closure(schema.encode(make_set(A)))), 
+            make_set(A, C, D));
+    ASSERT_EQ(schema.decode(engine.closure(schema.encode(make_set(B)))), 
+            make_set(B));
+}
+
+TEST(closure_engine, field_set_closure) {
+    const Field G = "G";
+    auto fds = make_set(
+            make_FD(make_set(A, B), C),
+            make_FD(C, D),
+            make_FD(FieldSet{}, E)
+    );
+    ClosureEngine engine{fds};
+
+    ASSERT_EQ(engine.schema().size(), 5);
+    ASSERT_EQ(engine.closure(make_set(A, B)), make_set(A, B, C, D));
+    ASSERT_EQ(engine.closure(make_set(A, G)), make_set(A, G));
+    ASSERT_EQ(engine.closure(make_set(B, C, G)), make_set(B, C, D, G));
+    ASSERT_EQ(engine.closure(FieldSet{}), FieldSet{});
+}
+
+TEST(closure_engine, closure_batch) {
+    const std::vector<Field> fields{A, B, C, D, E, F};
+    unsigned seed = 17;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    FDSet fds;
+    for (int i = 0; i < 6; i++) {
+        fds.insert(make_FD(make_set(fields[next() % 6], fields[next() % 6]), fields[next() % 6]));
+    }
+    fds.insert(make_FD(A, B));
+
+    std::vector<FieldSet> queries;
+    for (int i = 0; i < 500; i++) {
+        queries.push_back(make_set(fields[next() % 6], fields[next() % 6]));
+    }
+
+    ClosureEngine engine{fds};
+    auto closures = engine.closure_batch(queries);
+    ASSERT_EQ(closures.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); i++) {
+        ASSERT_EQ(closures[i], closure_of(queries[i], fds));
+    }
+
+    std::vector<AttributeSet> encoded;
+    for (auto& query: queries) {
+        encoded.push_back(engine.schema().encode(query));
+    }
+    auto sequential = engine.closure_batch(encoded);
+
+    ThreadPool pool{3};
+    std::vector<AttributeSet> parallel(encoded.size());
+    engine.closure_batch(encoded.data(), encoded.size(), parallel.data(), pool);
+    ASSERT_EQ(parallel, sequential);
+    for (size_t i = 0; i < queries.size(); i++) {
+        ASSERT_EQ(engine.schema().decode(parallel[i]), closures[i]);
+    }
+}
@@ -0,0 +1,132 @@
+#include "dataset.hpp"
+#include <gmock/gmock.h>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <unistd.h>
+
+static std::vector<std::vector<std::string>> rows_of(const Dataset& data) {
+    std::vector<std::vector<std::string>> result(data.row_count());
+    for (int r = 0; r < data.row_count(); r++) {
+        for (int c = 0; c < data.column_count(); c++) {
+            result[r].push_back(data.value(c, data.column(c)[r]));
+        }
+    }
+    return result;
+}
+
+static std::string write_temp_file(const std::string& content) {
+    char path[] = "/tmp/test_dataset_XXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    std::ofstream out{path, std::ios::binary};
+    out << content;
+    return path;
+}
+
+TEST(dataset, dictionary) {
+    detail::Dictionary dictionary;
+    ASSERT_EQ(dictionary.encode("red", 3), 0);
+    ASSERT_EQ(dictionary.encode("green", 5), 1);
+    ASSERT_EQ(dictionary.encode("red", 3), 0);
+    ASSERT_EQ(dictionary.encode("redder", 3), 0);
+    ASSERT_EQ(dictionary.encode("", 0), 2);
+    for (int i = 0; i < 1000; i++) {
+        auto value = std::to_string(i);
+        ASSERT_EQ(dictionary.encode(value.data(), value.size()), i + 3);
+    }
+    ASSERT_EQ(dictionary.encode("green", 5), 1);
+    ASSERT_EQ(dictionary.size(), 1003);
+    ASSERT_EQ(dictionary.value(500), "497");
+}
+
+TEST(dataset, read_csv_quoted) {
+    std::istringstream in{
+        "a,b,c\r\n"
+        "\"x,y\",\"say \"\"hi\"\"\",plain\r\n"
+        "\r\n"
+        "\"two\nlines\",,\n"
+        "short\n"
+        "1,2,3,4"};
+    auto data = read_csv(in);
+
+    ASSERT_EQ(data.header()[2], Field{"c"});
+    using Rows = std::vector<std::vector<std::string>>;
+    ASSERT_EQ(rows_of(data), (Rows{
+                {"x,y", "say \"hi\"", "plain"},
+                {"two\nlines", "", ""},
+                {"short", "", ""},
+                {"1", "2", "3"}}));
+}
+
+TEST(dataset, read_csv_escaped_columns) {
+    // Every column of the first row grows the unescape scratch
+    std::istringstream in{
+        "x,y,z\n"
+        "\"a\"\"b\",\"c\"\"d\",\"\"\"\"\n"
+        "\"e\"\"\",f,\"\"\"g\"\n"};
+    auto data = read_csv(in);
+
+    using Rows = std::vector<std::vector<std::string>>;
+    ASSERT_EQ(rows_of(data), (Rows{
+                {"a\"b", "c\"d", "\""},
+                {"e\"", "f", "\"g"}}));
+}
+
+TEST(dataset, read_csv) {
+    std::istringstream in{
+        "city,zip,street\n"
+        "Berlin,10115,Main\n"
+        "Berlin,10117,Main\n"
+        "Munich,80331,Main\n"
+        "Berlin,10115,Side\n"};
+    auto data = read_csv(in);
+
+    ASSERT_EQ(data.column_count(), 3);
+    ASSERT_EQ(data.row_count(), 4);
+    ASSERT_EQ(data.header()[1], Field{"zip"});
+
+    ASSERT_EQ(data.column(0), (std::vector<std::int32_t>{0, 0, 1, 0}));
+    ASSERT_EQ(data.column(1), (std::vector<std::int32_t>{0, 1, 2, 0}));
+    ASSERT_EQ(data.distinct_count(2), 2);
+    ASSERT_EQ(data.value(0, 1), "Munich");
+
+    auto schema = data.schema();
+    ASSERT_EQ(schema.id_of(Field{"street"}), 2);
+}
+
+TEST(dataset, load_csv_same_as_read_csv) {
+    // Rows longer than a page and quoted fields cross the window borders
+    std::string content = "id,name,note\n";
+    for (int i = 0; i < 3000; i++) {
+        content += std::to_string(i % 97) + ",";
+        content += i % 5 == 0 ? "\"n,\"\"" + std::to_string(i % 13) + "\"" : "n" + std::to_string(i % 13);
+        content += ",";
+        if (i % 1000 == 999)
+            content += std::string(9000, 'x');
+        content += i % 7 == 0 ? "\"a\nb\"\r\n" : "z\n";
+    }
+    auto path = write_temp_file(content);
+
+    std::istringstream in{content};
+    auto expected = read_csv(in);
+    ASSERT_EQ(expected.row_count(), 3000);
+
+    for (std::size_t window: {std::size_t{1}, std::size_t{10000}, std::size_t{1} << 20}) {
+        auto data = load_csv(path, window);
+        ASSERT_EQ(data.header(), expected.header());
+        ASSERT_EQ(rows_of(data), rows_of(expected));
+        for (int c = 0; c < data.column_count(); c++) {
+            ASSERT_EQ(data.column(c), expected.column(c));
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(dataset, load_csv_empty_and_missing) {
+    auto path = write_temp_file("");
+    ASSERT_EQ(load_csv(path).column_count(), 0);
+    std::remove(path.c_str());
+
+    ASSERT_THROW(load_csv("/nonexistent/file.csv"), std::system_error);
+}
@@ -1,5 +1,7 @@
 #include "fd_algorithm.hpp"
+#include "closure_engine.hpp"
 #include "util.hpp"
+#include "thread_pool.hpp"
 #include <gmock/gmock.h>
 
 const Field A = "A";
@@ -42,6 +44,17 @@ TEST(db_algorithm, candidate_key) {
     ASSERT_EQ(key, compared_set);
 }
 
+TEST(db_algorithm, candidate_key_independent_of_interning) {
+    // Y is interned first, the attributes are still tried in name order
+    const Field Y = "candidate_key_interning_Y";
+    const Field X = "candidate_key_interning_X";
+    auto fds = make_set(make_FD(X, Y), make_FD(Y, X));
+
+    ASSERT_EQ(candidate_key(make_set(X, Y), fds), make_set(Y));
+    ASSERT_EQ(all_candidate_keys(make_set(X, Y), fds).front(), make_set(Y));
+    ASSERT_EQ(minimal_cover(fds), fds);
+}
+
 TEST(db_algorithm, equivalent_after_remove) {
     auto fds = make_set(
             make_FD(make_set(A, B), C),
@@ -108,6 +121,40 @@ TEST(db_algorithm, equivalent_after_replace2) {
     ASSERT_TRUE(equivalent_after_replace(fds, replaced, replacing2));
 }
 
+TEST(db_algorithm, equivalent_after_random) {
+    const std::vector<Field> fields{A, B, C, D, E};
+    unsigned seed = 17;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+    auto random_fd = [&]() {
+        FieldSet X, Y;
+        int lhs_size = next() % 3;
+        for (int k = 0; k < lhs_size; k++)
+            X.insert(fields[next() % fields.size()]);
+        Y.insert(fields[next() % fields.size()]);
+        return make_FD(X, Y);
+    };
+
+    for (int round = 0; round < 100; round++) {
+        FDSet fds;
+        for (int i = 0; i < 5; i++)
+            fds.insert(random_fd());
+        auto oldfd = next() % 2 ? *fds.begin() : random_fd();
+        auto newfd = next() % 4 ? random_fd() : oldfd;
+
+        FDSet removed = fds - make_set(oldfd);
+        ASSERT_EQ(equivalent_after_remove(fds, oldfd),
+                is_subset(oldfd.second, closure_of(oldfd.first, removed)));
+
+        FDSet replaced = removed + make_set(newfd);
+        ASSERT_EQ(equivalent_after_replace(fds, oldfd, newfd),
+                is_subset(newfd.second, closure_of(newfd.first, fds)) &&
+                is_subset(oldfd.second, closure_of(oldfd.first, replaced)));
+    }
+}
+
 TEST(db_algorithm, minimal_cover) {
     auto fds = make_set(
             make_FD(A, make_set(B, C)),
@@ -195,3 +242,449 @@ TEST(db_algorithm, minimal_cover4) {
     auto compared_key = make_set(A, D);
     ASSERT_EQ(key, compared_key);
 }
+
+TEST(db_algorithm, compiled_closure_and_candidate_key) {
+    auto R = make_set(A, B, C, D, E, F);
+    auto fds = make_set(
+            make_FD(make_set(A, B), C),
+            make_FD(make_set(B, C), make_set(A, D)),
+            make_FD(D, E),
+            make_FD(make_set(C, F), B)
+    );
+
+    Schema schema{R};
+    auto F_ = schema.encode(fds);
+
+    auto closure = closure_of(schema.encode(make_set(A, B)), F_);
+    ASSERT_EQ(schema.decode(closure), make_set(A, B, C, D, E));
+
+    auto key = candidate_key(schema.all(), F_);
+    ASSERT_EQ(schema.decode(key), candidate_key(R, fds));
+}
+
+TEST(db_algorithm, compiled_minimal_cover) {
+    std::stringstream input{
+        "A BC\n"
+        "CD GHI\n"
+        "C EF\n"
+        "E F\n"
+        "I G\n"
+        "AB C\n"
+        "ABCD E\n"
+        "ACDF EG\n"
+    };
+
+    FDSet fds;
+    input >> fds;
+
+    Schema schema{field_set_from(fds)};
+    auto F_ = schema.encode(fds);
+
+    ASSERT_EQ(schema.decode(non_redundant(F_)), non_redundant(fds));
+    ASSERT_EQ(schema.decode(minimal_cover(F_)), minimal_cover(fds));
+}
+
+TEST(db_algorithm, compiled_minimal_cover_random) {
+    const std::vector<Field> fields{A, B, C, D, E, F, G, H};
+    unsigned seed = 12345;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    for (int round = 0; round < 50; round++) {
+        FDSet fds;
+        for (int i = 0; i < 8; i++) {
+            FieldSet X, Y;
+            for (int k = 0; k < 3; k++)
+                X.insert(fields[next() % fields.size()]);
+            Y.insert(fields[next() % fields.size()]);
+            fds.insert(make_FD(X, Y));
+        }
+
+        Schema schema{field_set_from(fds)};
+        auto F_ = schema.encode(fds);
+        ASSERT_EQ(schema.decode(minimal_cover(F_)), minimal_cover(fds));
+        ASSERT_EQ(schema.decode(non_redundant(F_)), non_redundant(fds));
+        ASSERT_EQ(schema.decode(candidate_key(schema.all(), F_)), 
+                candidate_key(field_set_from(fds), fds));
+    }
+}
+
+TEST(db_algorithm, all_candidate_keys) {
+    auto R = make_set(A, B, C, D, E);
+    auto fds = make_set(
+            make_FD(make_set(A, B), C),
+            make_FD(make_set(A, C), B),
+            make_FD(make_set(B, C), make_set(D, E))
+    );
+
+    auto keys = all_candidate_keys(R, fds);
+    ASSERT_EQ(keys.size(), 2);
+    ASSERT_TRUE(std::find(keys.begin(), keys.end(), make_set(A, B)) != keys.end());
+    ASSERT_TRUE(std::find(keys.begin(), keys.end(), make_set(A, C)) != keys.end());
+}
+
+TEST(db_algorithm, all_candidate_keys_cycle) {
+    auto R = make_set(A, B, C, D);
+    auto fds = make_set(
+            make_FD(A, B),
+            make_FD(B, C),
+            make_FD(C, A)
+    );
+
+    auto keys = all_candidate_keys(R, fds);
+    std::sort(keys.begin(), keys.end());
+    std::vector<FieldSet> expected{
+        make_set(A, D), make_set(B, D), make_set(C, D)
+    };
+    ASSERT_EQ(keys, expected);
+
+    int count = 0;
+    all_candidate_keys(R, fds, [&count](const FieldSet&) {
+        count++;
+        return false;
+    });
+    ASSERT_EQ(count, 1);
+}
+
+TEST(db_algorithm, classify_attributes) {
+    auto U = make_set(A, B, C, D, E, F);
+    auto fds = make_set(
+            make_FD(make_set(A, B), C),
+            make_FD(C, make_set(B, D)),
+            make_FD(D, E)
+    );
+
+    auto classes = classify_attributes(U, fds);
+    ASSERT_EQ(classes.L, make_set(A));
+    ASSERT_EQ(classes.R, make_set(E));
+    ASSERT_EQ(classes.LR, make_set(B, C, D));
+    ASSERT_EQ(classes.N, make_set(F));
+
+    Schema schema{U};
+    auto compiled = classify_attributes(schema.all(), schema.encode(fds));
+    ASSERT_EQ(schema.decode(compiled.L), classes.L);
+    ASSERT_EQ(schema.decode(compiled.R), classes.R);
+    ASSERT_EQ(schema.decode(compiled.LR), classes.LR);
+    ASSERT_EQ(schema.decode(compiled.N), classes.N);
+}
+
+TEST(db_algorithm, candidate_key_from_core) {
+    auto U = make_set(A, B, C, D, E, F);
+    auto fds = make_set(
+            make_FD(A, make_set(B, C)),
+            make_FD(C, D),
+            make_FD(make_set(A, F), E)
+    );
+
+    ASSERT_EQ(candidate_key(U, fds), make_set(A, F));
+    ASSERT_EQ(all_candidate_keys(U, fds), std::vector<FieldSet>{make_set(A, F)});
+}
+
+TEST(db_algorithm, all_candidate_keys_random) {
+    const std::vector<Field> fields{A, B, C, D, E, F};
+    const auto U = make_set(A, B, C, D, E, F);
+    unsigned seed = 7;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    for (int round = 0; round < 30; round++) {
+        FDSet fds;
+        for (int i = 0; i < 5; i++) {
+            FieldSet X, Y;
+            for (int k = 0; k < 2; k++)
+                X.insert(fields[next() % fields.size()]);
+            Y.insert(fields[next() % fields.size()]);
+            fds.insert(make_FD(X, Y));
+        }
+
+        std::vector<FieldSet> expected;
+        for (int mask = 0; mask < (1 << fields.size()); mask++) {
+            FieldSet S;
+            for (size_t k = 0; k < fields.size(); k++) {
+                if (mask & (1 << k))
+                    S.insert(fields[k]);
+            }
+            if (closure_of(S, fds) != U)
+                continue;
+            bool minimal = std::all_of(S.begin(), S.end(), [&](const Field& f) {
+                return closure_of(S - make_set(f), fds) != U;
+            });
+            if (minimal)
+                expected.push_back(S);
+        }
+
+        auto keys = all_candidate_keys(U, fds);
+        std::sort(keys.begin(), keys.end());
+        std::sort(expected.begin(), expected.end());
+        ASSERT_EQ(keys, expected);
+    }
+}
+
+TEST(db_algorithm, implies) {
+    auto fds = make_set(
+            make_FD(A, B),
+            make_FD(B, C),
+            make_FD(make_set(C, D), E)
+    );
+
+    ASSERT_TRUE(implies(fds, make_FD(A, C)));
+    ASSERT_TRUE(implies(fds, make_FD(make_set(A, D), make_set(B, E))));
+    ASSERT_TRUE(implies(fds, make_FD(make_set(F, G), F)));
+    ASSERT_FALSE(implies(fds, make_FD(A, E)));
+    ASSERT_FALSE(implies(fds, make_FD(F, A)));
+    // FDs with an empty LHS hold for every LHS
+    auto constant = make_set(make_FD(FieldSet{}, A), make_FD(A, B));
+    ASSERT_TRUE(implies(constant, make_FD(C, make_set(A, B))));
+    ASSERT_TRUE(implies(constant, make_FD(FieldSet{}, B)));
+    ASSERT_FALSE(implies(constant, make_FD(C, D)));
+    ASSERT_TRUE(implies_all(constant, constant));
+
+    ASSERT_TRUE(implies_all(fds, make_set(make_FD(A, C), make_FD(make_set(A, D), E))));
+    ASSERT_FALSE(implies_all(fds, make_set(make_FD(A, C), make_FD(C, E))));
+    ASSERT_TRUE(implies_all(fds, fds));
+    ASSERT_TRUE(implies_all(FDSet{}, FDSet{}));
+    ASSERT_FALSE(implies_all(FDSet{}, fds));
+}
+
+TEST(db_algorithm, equivalent) {
+    auto fds = make_set(
+            make_FD(A, B),
+            make_FD(B, C),
+            make_FD(make_set(A, B), C)
+    );
+    auto cover = make_set(
+            make_FD(A, make_set(B, C)),
+            make_FD(B, C)
+    );
+
+    ASSERT_TRUE(equivalent(fds, cover));
+    ASSERT_TRUE(equivalent(cover, minimal_cover(fds)));
+    ASSERT_FALSE(equivalent(fds, make_set(make_FD(A, B))));
+    ASSERT_FALSE(equivalent(make_set(make_FD(A, B)), fds));
+    ASSERT_FALSE(equivalent(make_set(make_FD(FieldSet{}, A)), FDSet{}));
+    ASSERT_TRUE(equivalent(FDSet{}, make_set(make_FD(A, A))));
+
+    auto constant = make_set(make_FD(FieldSet{}, A), make_FD(A, B));
+    ASSERT_TRUE(equivalent(constant, constant));
+    ASSERT_TRUE(equivalent(constant, minimal_cover(constant)));
+    ASSERT_TRUE(equivalent(constant, make_set(make_FD(FieldSet{}, make_set(A, B)))));
+    ASSERT_FALSE(equivalent(constant, make_set(make_FD(FieldSet{}, A))));
+
+    Schema schema{make_set(A, B)};
+    auto compiled = schema.encode(constant);
+    ASSERT_TRUE(equivalent(compiled, compiled));
+    ASSERT_TRUE(equivalent(compiled, minimal_cover(compiled)));
+    ASSERT_TRUE(equivalent(compiled, schema.encode(make_set(make_FD(FieldSet{}, make_set(A, B))))));
+}
+
+TEST(db_algorithm, equivalent_random) {
+    const std::vector<Field> fields{A, B, C, D, E, F};
+    unsigned seed = 11;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+    auto random_fds = [&]() {
+        FDSet fds;
+        for (int i = 0; i < 4; i++) {
+            FieldSet X, Y;
+            int lhs_size = next() % 8 == 0 ? 0 : 2;
+            for (int k = 0; k < lhs_size; k++)
+                X.insert(fields[next() % fields.size()]);
+            Y.insert(fields[next() % fields.size()]);
+            fds.insert(make_FD(X, Y));
+        }
+        return fds;
+    };
+
+    Schema schema{make_set(A, B, C, D, E, F)};
+    for (int round = 0; round < 100; round++) {
+        auto fds = random_fds();
+        auto other = random_fds();
+        FieldSet constants;
+        for (auto& fd: fds) {
+            if (fd.first.empty())
+                constants = constants + fd.second;
+        }
+        bool expected = std::all_of(other.begin(), other.end(), [&](const FD& fd) {
+            return is_subset(fd.second, closure_of(fd.first + constants, fds));
+        });
+        ASSERT_EQ(implies_all(fds, other), expected);
+        ASSERT_EQ(implies_all(schema.encode(fds), schema.encode(other)), expected);
+        ASSERT_TRUE(equivalent(fds, minimal_cover(fds)));
+        ASSERT_TRUE(equivalent(schema.encode(fds), minimal_cover(schema.encode(fds))));
+        ASSERT_EQ(equivalent(fds, other), expected && implies_all(other, fds));
+    }
+}
+
+TEST(db_algorithm, minimal_cover_parallel) {
+    const std::vector<Field> fields{A, B, C, D, E, F, G, H, I, J};
+    unsigned seed = 99;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    ThreadPool single{1};
+    ThreadPool pool{4};
+    for (int round = 0; round < 50; round++) {
+        FDSet fds;
+        int fd_count = 5 + next() % 40;
+        for (int i = 0; i < fd_count; i++) {
+            FieldSet X, Y;
+            int lhs_size = 1 + next() % 4;
+            for (int k = 0; k < lhs_size; k++)
+                X.insert(fields[next() % fields.size()]);
+            for (int k = 0; k < 2; k++)
+                Y.insert(fields[next() % fields.size()]);
+            fds.insert(make_FD(X, Y));
+        }
+
+        Schema schema{field_set_from(fds)};
+        auto F_ = schema.encode(fds);
+        auto cover = minimal_cover(F_);
+        ASSERT_EQ(minimal_cover(F_, single), cover);
+        ASSERT_EQ(minimal_cover(F_, pool), cover);
+        ASSERT_EQ(minimal_cover(fds, pool), minimal_cover(fds));
+    }
+
+    ASSERT_EQ(minimal_cover(FDSet{}, pool), FDSet{});
+}
+
+TEST(db_algorithm, minimum_cover) {
+    // AC and BC are equivalent and AC directly determines BC
+    auto fds = make_set(
+            make_FD(A, B),
+            make_FD(B, A),
+            make_FD(make_set(A, C), D),
+            make_FD(make_set(B, C), E)
+    );
+    auto expected = make_set(
+            make_FD(A, B),
+            make_FD(B, A),
+            make_FD(make_set(B, C), make_set(D, E))
+    );
+    ASSERT_EQ(minimal_cover(fds).size(), 4u);
+    ASSERT_EQ(minimum_cover(fds), expected);
+
+    ASSERT_EQ(minimum_cover(make_set(make_FD(A, make_set(A, B)), make_FD(A, C))),
+            make_set(make_FD(A, make_set(B, C))));
+    ASSERT_EQ(minimum_cover(FDSet{}), FDSet{});
+}
+
+TEST(db_algorithm, minimum_cover_random) {
+    const std::vector<Field> fields{A, B, C, D};
+    unsigned seed = 5;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    // Every cover with k FDs gives one of k FDs X -> closure of X, so
+    // the fewest FDs is the smallest set of LHS whose such FDs are
+    // equivalent to the FD set.
+    Schema schema{make_set(A, B, C, D)};
+    auto fewest_fds = [&schema](const AttributeFDSet& fds) {
+        ClosureEngine engine{fds};
+        AttributeFDSet all;
+        for (int lhs = 1; lhs < 16; lhs++) {
+            AttributeSet X(4);
+            for (int id = 0; id < 4; id++) {
+                if ((lhs >> id) & 1)
+                    X.insert(id);
+            }
+            all.emplace_back(X, engine.closure(X));
+        }
+        size_t result = fds.size();
+        for (int subset = 0; subset < (1 << 15); subset++) {
+            if (static_cast<size_t>(__builtin_popcount(subset)) >= result)
+                continue;
+            AttributeFDSet chosen;
+            for (int i = 0; i < 15; i++) {
+                if ((subset >> i) & 1)
+                    chosen.push_back(all[i]);
+            }
+            if (equivalent(chosen, fds))
+                result = chosen.size();
+        }
+        return result;
+    };
+
+    for (int round = 0; round < 30; round++) {
+        FDSet fds;
+        int fd_count = 2 + next() % 6;
+        for (int i = 0; i < fd_count; i++) {
+            FieldSet X, Y;
+            int lhs_size = 1 + next() % 2;
+            for (int k = 0; k < lhs_size; k++)
+                X.insert(fields[next() % fields.size()]);
+            Y.insert(fields[next() % fields.size()]);
+            fds.insert(make_FD(X, Y));
+        }
+
+        auto F_ = schema.encode(fds);
+        auto cover = minimum_cover(F_);
+        ASSERT_TRUE(equivalent(cover, F_));
+        ASSERT_EQ(cover.size(), fewest_fds(F_));
+        ASSERT_EQ(schema.decode(cover), minimum_cover(fds));
+    }
+}
+
+TEST(db_algorithm, transversal_candidate_keys) {
+    auto R = make_set(A, B, C, D, E);
+    auto fds = make_set(
+            make_FD(make_set(A, B), C),
+            make_FD(make_set(A, C), B),
+            make_FD(make_set(B, C), make_set(D, E))
+    );
+    auto keys = transversal_candidate_keys(R, fds);
+    std::sort(keys.begin(), keys.end());
+    ASSERT_EQ(keys, (std::vector<FieldSet>{make_set(A, B), make_set(A, C)}));
+
+    auto cycle = make_set(make_FD(A, B), make_FD(B, C), make_FD(C, A));
+    keys = transversal_candidate_keys(make_set(A, B, C, D), cycle);
+    std::sort(keys.begin(), keys.end());
+    ASSERT_EQ(keys, (std::vector<FieldSet>{make_set(A, D), make_set(B, D), make_set(C, D)}));
+    ASSERT_EQ(transversal_candidate_keys(make_set(A, B, C, D), cycle, 2).size(), 2u);
+    ASSERT_TRUE(transversal_candidate_keys(make_set(A, B, C, D), cycle, 0).empty());
+
+    ASSERT_EQ(transversal_candidate_keys(make_set(A, B), FDSet{}),
+            std::vector<FieldSet>{make_set(A, B)});
+}
+
+TEST(db_algorithm, transversal_candidate_keys_random) {
+    const std::vector<Field> fields{A, B, C, D, E, F, G, H};
+    unsigned seed = 13;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    for (int round = 0; round < 100; round++) {
+        FDSet fds;
+        int fd_count = 1 + next() % 10;
+        for (int i = 0; i < fd_count; i++) {
+            FieldSet X, Y;
+            int lhs_size = next() % 4;
+            for (int k = 0; k < lhs_size; k++)
+                X.insert(fields[next() % fields.size()]);
+            Y.insert(fields[next() % fields.size()]);
+            fds.insert(make_FD(X, Y));
+        }
+        FieldSet U = field_set_from(fds);
+        for (auto& field: fields) {
+            if (next() % 4 == 0)
+                U.insert(field);
+        }
+
+        auto expected = all_candidate_keys(U, fds);
+        auto keys = transversal_candidate_keys(U, fds);
+        std::sort(expected.begin(), expected.end());
+        std::sort(keys.begin(), keys.end());
+        ASSERT_EQ(keys, expected);
+    }
+}
@@ -0,0 +1,339 @@
+#include "fd_discovery.hpp"
+#include <gmock/gmock.h>
+#include "fd_algorithm.hpp"
+#include "normal_form.hpp"
+#include "lossless_decomposition.hpp"
+#include "instrumentation.hpp"
+#include <sstream>
+
+using detail::StrippedPartition;
+
+static std::vector<std::vector<std::int32_t>> classes_of(const StrippedPartition& partition) {
+    std::vector<std::vector<std::int32_t>> result;
+    for (int i = 0; i < partition.class_count(); i++) {
+        result.emplace_back(partition.rows.begin() + partition.offsets[i],
+                partition.rows.begin() + partition.offsets[i + 1]);
+    }
+    return result;
+}
+
+// Holds when rows agreeing on X agree on a
+static bool holds(const Dataset& data, const AttributeSet& X, int a) {
+    for (int r = 0; r < data.row_count(); r++) {
+        for (int s = r + 1; s < data.row_count(); s++) {
+            bool agree = true;
+            X.for_each([&](int c) {
+                agree = agree && data.column(c)[r] == data.column(c)[s];
+            });
+            if (agree && data.column(a)[r] != data.column(a)[s])
+                return false;
+        }
+    }
+    return true;
+}
+
+// Rows to remove for X -> a to hold
+static int violations(const Dataset& data, const AttributeSet& X, int a) {
+    std::map<std::vector<std::int32_t>, std::map<std::int32_t, int>> groups;
+    for (int r = 0; r < data.row_count(); r++) {
+        std::vector<std::int32_t> key;
+        X.for_each([&](int c) { key.push_back(data.column(c)[r]); });
+        groups[key][data.column(a)[r]]++;
+    }
+    int result = 0;
+    for (auto& group: groups) {
+        int total = 0, most = 0;
+        for (auto& count: group.second) {
+            total += count.second;
+            most = std::max(most, count.second);
+        }
+        result += total - most;
+    }
+    return result;
+}
+
+TEST(fd_discovery, partition_of_column) {
+    auto partition = detail::partition_of_column({0, 1, 0, 2, 1, 0}, 3);
+    using C = std::vector<std::vector<std::int32_t>>;
+    ASSERT_EQ(classes_of(partition), (C{{0, 2, 5}, {1, 4}}));
+    ASSERT_EQ(partition.error(), 3);
+
+    ASSERT_EQ(detail::partition_of_rows(3).error(), 2);
+    ASSERT_TRUE(detail::partition_of_rows(1).is_key());
+}
+
+TEST(fd_discovery, partition_product) {
+    auto left = detail::partition_of_column({0, 0, 0, 1, 1, 2}, 3);
+    auto right = detail::partition_of_column({0, 1, 0, 1, 1, 0}, 2);
+    detail::PartitionProduct product{6};
+
+    using C = std::vector<std::vector<std::int32_t>>;
+    ASSERT_EQ(classes_of(product(left, right)), (C{{0, 2}, {3, 4}}));
+    ASSERT_EQ(classes_of(product(right, left)), (C{{0, 2}, {3, 4}}));
+    ASSERT_TRUE(detail::refines(left, {5, 5, 5, 7, 7, 9}));
+    ASSERT_FALSE(detail::refines(left, {5, 5, 6, 7, 7, 9}));
+}
+
+TEST(fd_discovery, violations) {
+    auto partition = detail::partition_of_column({0, 0, 0, 0, 1, 1, 2}, 3);
+    std::vector<std::int32_t> counts(4, 0);
+    ASSERT_EQ(detail::violations(partition, {1, 1, 3, 2, 0, 0, 1}, counts), 2);
+    ASSERT_EQ(detail::violations(partition, {1, 1, 1, 1, 0, 2, 3}, counts), 1);
+    ASSERT_EQ(counts, std::vector<std::int32_t>(4, 0));
+}
+
+TEST(fd_discovery, discover_fds_csv) {
+    std::istringstream in{
+        "A,B,C,D\n"
+        "1,x,p,u\n"
+        "1,x,q,u\n"
+        "2,y,p,u\n"
+        "3,y,q,u\n"
+        "3,y,r,u\n"};
+    auto data = read_csv(in);
+    const Field A = "A", B = "B", C = "C", D = "D";
+
+    auto fds = discover_fds(data);
+    ASSERT_EQ(fds, make_set(
+                make_FD(FieldSet{}, D),
+                make_FD(A, B),
+                make_FD(make_set(B, C), A)));
+
+    const auto U = make_set(A, B, C, D);
+    auto cover = minimal_cover(fds);
+    auto R_list = convert_3nf(U, cover);
+    ASSERT_TRUE(is_lossless_decomposition(U, cover, R_list));
+}
+
+TEST(fd_discovery, discover_fds_superkey) {
+    // A is a key, but neither B nor C alone determines A
+    std::istringstream in{
+        "A,B,C\n"
+        "1,0,0\n"
+        "2,0,1\n"
+        "3,1,0\n"
+        "4,1,1\n"};
+    auto data = read_csv(in);
+    const Field A = "A", B = "B", C = "C";
+
+    ASSERT_EQ(discover_fds(data), make_set(
+                make_FD(A, B),
+                make_FD(A, C),
+                make_FD(make_set(B, C), A)));
+}
+
+TEST(fd_discovery, discover_fds_same_as_brute_force) {
+    unsigned seed = 7;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    for (int round = 0; round < 60; round++) {
+        int columns = 2 + next() % 5;
+        std::vector<Field> header;
+        for (int c = 0; c < columns; c++) {
+            header.push_back(Field{"c" + std::to_string(c)});
+        }
+        Dataset data{header};
+        int rows = next() % 12;
+        int domain = 1 + next() % 4;
+        for (int r = 0; r < rows; r++) {
+            std::vector<std::string> values;
+            for (int c = 0; c < columns; c++) {
+                values.push_back(std::to_string(next() % domain));
+            }
+            data.append_row(values);
+        }
+
+        std::set<std::pair<AttributeSet, int>> found;
+        discover_fds(data, [&](const AttributeFD& fd) {
+            ASSERT_EQ(fd.second.size(), 1);
+            ASSERT_TRUE(found.emplace(fd.first, fd.second.next(0)).second);
+        });
+
+        std::set<std::pair<AttributeSet, int>> expected;
+        for (int mask = 0; mask < (1 << columns); mask++) {
+            AttributeSet X(columns);
+            for (int c = 0; c < columns; c++) {
+                if (mask >> c & 1)
+                    X.insert(c);
+            }
+            for (int a = 0; a < columns; a++) {
+                if (X.contains(a) || !holds(data, X, a))
+                    continue;
+                bool minimal = true;
+                X.for_each([&](int b) {
+                    AttributeSet Y = X;
+                    Y.erase(b);
+                    minimal = minimal && !holds(data, Y, a);
+                });
+                if (minimal)
+                    expected.emplace(X, a);
+            }
+        }
+        ASSERT_EQ(found, expected);
+    }
+}
+
+TEST(fd_discovery, parallel_same_as_sequential) {
+    unsigned seed = 11;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    std::vector<Field> header;
+    for (int c = 0; c < 8; c++) {
+        header.push_back(Field{"p" + std::to_string(c)});
+    }
+    Dataset data{header};
+    for (int r = 0; r < 300; r++) {
+        std::vector<std::int32_t> codes;
+        for (int c = 0; c < 6; c++) {
+            codes.push_back(next() % (2 + c));
+        }
+        codes.push_back((codes[0] * 3 + codes[1]) % 5);
+        codes.push_back(codes[2] + codes[3]);
+        std::vector<std::string> values;
+        for (auto code: codes) {
+            values.push_back(std::to_string(code));
+        }
+        data.append_row(values);
+    }
+
+    AttributeFDSet sequential;
+    discover_fds(data, [&](const AttributeFD& fd) { sequential.push_back(fd); });
+
+    for (int threads: {2, 4, 7}) {
+        ThreadPool pool{threads};
+        AttributeFDSet parallel;
+        discover_fds(data, [&](const AttributeFD& fd) { parallel.push_back(fd); }, pool);
+        ASSERT_EQ(parallel, sequential);
+        ASSERT_EQ(discover_fds(data, pool), discover_fds(data));
+    }
+}
+
+TEST(fd_discovery, discover_approximate_fds) {
+    std::istringstream in{
+        "zip,city\n"
+        "1,Berlin\n"
+        "1,Berlin\n"
+        "1,Berlin\n"
+        "1,Berlim\n"
+        "2,Munich\n"
+        "2,Munich\n"
+        "3,Hamburg\n"
+        "4,Hamburg\n"
+        "5,Bonn\n"
+        "6,Bonn\n"};
+    auto data = read_csv(in);
+    const Field zip = "zip", city = "city";
+
+    ASSERT_TRUE(discover_fds(data).empty());
+
+    ApproximateFDOptions options;
+    options.max_error = 0.1;
+    std::map<FD, double> errors;
+    auto fds = discover_approximate_fds(data, options, errors);
+    ASSERT_EQ(fds, make_set(make_FD(zip, city)));
+    ASSERT_DOUBLE_EQ(errors[make_FD(zip, city)], 0.1);
+
+    auto R_list = convert_3nf(make_set(zip, city), minimal_cover(fds));
+    ASSERT_EQ(R_list, std::vector<FieldSet>{make_set(zip, city)});
+}
+
+TEST(fd_discovery, discover_approximate_fds_same_as_brute_force) {
+    unsigned seed = 3;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    for (int round = 0; round < 60; round++) {
+        int columns = 2 + next() % 4;
+        std::vector<Field> header;
+        for (int c = 0; c < columns; c++) {
+            header.push_back(Field{"a" + std::to_string(c)});
+        }
+        Dataset data{header};
+        int rows = 1 + next() % 30;
+        int domain = 1 + next() % 4;
+        for (int r = 0; r < rows; r++) {
+            std::vector<std::string> values;
+            for (int c = 0; c < columns; c++) {
+                values.push_back(std::to_string(next() % domain));
+            }
+            data.append_row(values);
+        }
+
+        ApproximateFDOptions options;
+        options.max_error = (next() % 30) / 100.0;
+        options.sample_size = next() % 2 == 0 ? 0 : 1 + next() % rows;
+        options.seed = next();
+        ThreadPool pool{1 + round % 3};
+
+        std::map<std::pair<AttributeSet, int>, double> found;
+        discover_approximate_fds(data, options, [&](const AttributeFD& fd, double error) {
+            ASSERT_TRUE(found.emplace(std::make_pair(fd.first, fd.second.next(0)), error).second);
+        }, pool);
+
+        auto allowed = [&](int count) {
+            return count <= options.max_error * rows + 1e-9;
+        };
+        std::map<std::pair<AttributeSet, int>, double> expected;
+        for (int mask = 0; mask < (1 << columns); mask++) {
+            AttributeSet X(columns);
+            for (int c = 0; c < columns; c++) {
+                if (mask >> c & 1)
+                    X.insert(c);
+            }
+            for (int a = 0; a < columns; a++) {
+                int count = violations(data, X, a);
+                if (X.contains(a) || !allowed(count))
+                    continue;
+                bool minimal = true;
+                X.for_each([&](int b) {
+                    AttributeSet Y = X;
+                    Y.erase(b);
+                    minimal = minimal && !allowed(violations(data, Y, a));
+                });
+                if (minimal)
+                    expected.emplace(std::make_pair(X, a), static_cast<double>(count) / rows);
+            }
+        }
+        ASSERT_EQ(found, expected);
+    }
+}
+
+TEST(fd_discovery, approximate_sample_rejects) {
+    // x has 10 classes of 2000 rows and a is random: x -> a has about 10000
+    // violations but passes the bound e(x) - e(x + a) = 10. The budget of
+    // the full data, 200, is more than the 150 rows of the sample.
+    unsigned seed = 5;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+    Dataset data{{Field{"x"}, Field{"a"}, Field{"id"}}};
+    for (int r = 0; r < 20000; r++) {
+        data.append_row({std::to_string(r % 10), std::to_string(next() % 2), std::to_string(r)});
+    }
+
+    std::map<FD, double> errors;
+    ApproximateFDOptions options;
+    options.sample_size = 150;
+    reset_algorithm_stats();
+    auto sampled = discover_approximate_fds(data, options, errors);
+    auto rejections = algorithm_stats().sample_rejections;
+
+    options.sample_miss_probability = 0;
+    reset_algorithm_stats();
+    ASSERT_EQ(discover_approximate_fds(data, options, errors), sampled);
+    ASSERT_EQ(algorithm_stats().sample_rejections, 0u);
+
+    options.sample_size = 0;
+    ASSERT_EQ(discover_approximate_fds(data, options, errors), sampled);
+    if (instrumentation_enabled)
+        ASSERT_GT(rejections, 0u);
+}
@@ -0,0 +1,113 @@
+#include "fd_parser.hpp"
+#include <gmock/gmock.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+static std::string write_temp_file(const std::string& content) {
+    char path[] = "/tmp/test_fd_parser_XXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    std::ofstream out{path, std::ios::binary};
+    out << content;
+    return path;
+}
+
+TEST(fd_parser, parse_fds) {
+    const Field zip = "zip code";
+    const Field street = "street";
+    const Field city = "city";
+    const Field country = "country";
+
+    Schema schema;
+    auto fds = parse_fds(
+            "# addresses\n"
+            "zip code, street -> city\n"
+            "\n"
+            "  city->country  \r\n"
+            "-> country\n"
+            "zip code ->\n"
+            "city -> country", schema);
+
+    ASSERT_EQ(schema.size(), 4);
+    ASSERT_EQ(schema.field_of(0), zip);
+    ASSERT_EQ(schema.field_of(3), country);
+    ASSERT_EQ(fds.size(), 5u);
+    ASSERT_EQ(schema.decode(fds[0]), make_FD(make_set(zip, street), city));
+    ASSERT_EQ(schema.decode(fds[1]), make_FD(city, country));
+    ASSERT_EQ(schema.decode(fds[2]), make_FD(FieldSet{}, country));
+    ASSERT_EQ(schema.decode(fds[3]), make_FD(zip, FieldSet{}));
+    ASSERT_EQ(fds[4], fds[1]);
+    for (auto& fd: fds) {
+        ASSERT_EQ(fd.first.universe_size(), 4);
+        ASSERT_EQ(fd.second.universe_size(), 4);
+    }
+}
+
+TEST(fd_parser, existing_schema) {
+    const Field A = "A";
+    const Field B = "B";
+    const Field C = "C";
+
+    Schema schema{make_set(A, B)};
+    auto fds = parse_fds("C -> A\nB-C -> A\n", schema);
+    ASSERT_EQ(schema.size(), 4);
+    ASSERT_EQ(schema.id_of(A), 0);
+    ASSERT_EQ(schema.id_of(C), 2);
+    ASSERT_EQ(schema.decode(fds[0]), make_FD(C, A));
+    ASSERT_EQ(schema.decode(fds[1]), make_FD(Field{"B-C"}, A));
+}
+
+TEST(fd_parser, errors) {
+    Schema schema;
+    try {
+        parse_fds("A -> B\n\nA, B\n", schema);
+        FAIL();
+    }
+    catch (const std::invalid_argument& e) {
+        ASSERT_EQ(std::string{e.what()}, "line 3: expected ->");
+    }
+    ASSERT_THROW(parse_fds("A, , B -> C\n", schema), std::invalid_argument);
+    ASSERT_THROW(parse_fds("A -> B,\n", schema), std::invalid_argument);
+    ASSERT_THROW(parse_fds("A -\n", schema), std::invalid_argument);
+    try {
+        parse_fds("A -> B\nA -> B -> C\n", schema);
+        FAIL();
+    }
+    catch (const std::invalid_argument& e) {
+        ASSERT_EQ(std::string{e.what()}, "line 2: more than one ->");
+    }
+}
+
+TEST(fd_parser, write_and_load) {
+    Schema schema;
+    std::ostringstream text;
+    for (int i = 0; i < 1000; i++) {
+        text << "attr " << i % 37 << ", attr " << i % 11 << " -> attr " << i % 53 << "\n";
+    }
+    auto fds = parse_fds(text.str(), schema);
+    ASSERT_EQ(fds.size(), 1000u);
+
+    std::ostringstream written;
+    write_fds(written, schema, fds);
+    auto path = write_temp_file(written.str());
+    Schema loaded_schema;
+    auto loaded = load_fds(path, loaded_schema);
+    std::remove(path.c_str());
+    ASSERT_EQ(loaded_schema.decode(loaded), schema.decode(fds));
+
+    std::istringstream in{written.str()};
+    Schema read_schema;
+    ASSERT_EQ(read_schema.decode(read_fds(in, read_schema)), schema.decode(fds));
+}
+
+TEST(fd_parser, load_empty_and_missing) {
+    auto path = write_temp_file("");
+    Schema schema;
+    ASSERT_TRUE(load_fds(path, schema).empty());
+    std::remove(path.c_str());
+
+    ASSERT_THROW(load_fds("/nonexistent/file.fds", schema), std::system_error);
+}
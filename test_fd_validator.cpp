@@ -0,0 +1,140 @@
+#include "fd_validator.hpp"
+#include <gmock/gmock.h>
+#include <sstream>
+#include <stdexcept>
+
+const Field zip = "zip";
+const Field city = "city";
+const Field street = "street";
+const Field district = "district";
+
+TEST(fd_validator, tuple_index) {
+    detail::TupleIndex index{2};
+    bool inserted;
+    std::int32_t a[] = {1, 2}, b[] = {2, 1};
+    ASSERT_EQ(index.insert(a, inserted), 0);
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(index.insert(b, inserted), 1);
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(index.insert(a, inserted), 0);
+    ASSERT_FALSE(inserted);
+
+    for (std::int32_t i = 0; i < 1000; i++) {
+        std::int32_t key[] = {i, -i};
+        ASSERT_EQ(index.insert(key, inserted), i + 2);
+    }
+    ASSERT_EQ(index.insert(b, inserted), 1);
+    ASSERT_EQ(index.size(), 1002);
+
+    detail::TupleIndex empty{0};
+    ASSERT_EQ(empty.insert(nullptr, inserted), 0);
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(empty.insert(nullptr, inserted), 0);
+    ASSERT_FALSE(inserted);
+}
+
+TEST(fd_validator, append) {
+    const auto fds = make_set(
+                make_FD(zip, city),
+                make_FD(make_set(city, street), district));
+    FDValidator validator{fds, {zip, city, street, district}};
+
+    ASSERT_TRUE(validator.append({
+                {"10115", "Berlin", "Main", "Mitte"},
+                {"10115", "Berlin", "Side", "Mitte"},
+                {"80331", "Munich", "Main", "Altstadt"}}).empty());
+
+    // Same zip, another city: only zip -> city breaks
+    ASSERT_EQ(validator.append({
+                {"80331", "Munich", "Main", "Altstadt"},
+                {"10115", "Potsdam", "Main", "Zentrum"}}), make_set(make_FD(zip, city)));
+
+    // Reported once
+    ASSERT_EQ(validator.append({
+                {"10115", "Bonn", "Side", "Mitte"},
+                {"10117", "Berlin", "Main", "Wedding"}}), 
+            make_set(make_FD(make_set(city, street), district)));
+
+    ASSERT_EQ(validator.violated(), fds);
+    ASSERT_EQ(validator.row_count(), 7);
+
+    ASSERT_THROW(validator.append({
+                {"10115", "Berlin", "Main", "Mitte"},
+                {"10115", "Berlin", "Main"}}), std::invalid_argument);
+    ASSERT_EQ(validator.row_count(), 7);
+}
+
+TEST(fd_validator, append_dataset) {
+    const auto fds = make_set(make_FD(zip, city), make_FD(FieldSet{}, street));
+    FDValidator validator{fds, {zip, city, street}};
+
+    std::istringstream first{"city,zip,street\nBerlin,10115,Main\nMunich,80331,Main\n"};
+    ASSERT_TRUE(validator.append(read_csv(first)).empty());
+
+    std::istringstream second{"street,zip,city\nMain,80331,Munich\nSide,10115,Berlin\n"};
+    ASSERT_EQ(validator.append(read_csv(second)), make_set(make_FD(FieldSet{}, street)));
+}
+
+TEST(fd_validator, unknown_field) {
+    ASSERT_THROW((FDValidator{make_set(make_FD(zip, city)), {zip}}), std::invalid_argument);
+}
+
+TEST(fd_validator, same_as_full_check) {
+    unsigned seed = 5;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+    const std::vector<Field> header{zip, city, street, district};
+
+    for (int round = 0; round < 30; round++) {
+        FDSet fds;
+        for (int i = 0; i < 4; i++) {
+            FieldSet X, Y;
+            X.insert(header[next() % 4]);
+            if (next() % 2)
+                X.insert(header[next() % 4]);
+            Y.insert(header[next() % 4]);
+            fds.insert(make_FD(X, Y));
+        }
+
+        FDValidator validator{fds, header};
+        std::vector<std::vector<std::string>> table;
+        FDSet reported;
+        for (int batch = 0; batch < 5; batch++) {
+            std::vector<std::vector<std::string>> rows;
+            for (int r = 0; r < 3; r++) {
+                std::vector<std::string> row;
+                for (int c = 0; c < 4; c++) {
+                    row.push_back(std::to_string(next() % 3));
+                }
+                rows.push_back(row);
+            }
+            table.insert(table.end(), rows.begin(), rows.end());
+            auto newly = validator.append(rows);
+            ASSERT_TRUE(is_subset(newly, fds - reported));
+            reported += newly;
+
+            FDSet expected;
+            for (auto& fd: fds) {
+                auto project = [&](const std::vector<std::string>& row, const FieldSet& fields) {
+                    std::vector<std::string> result;
+                    for (auto& field: fields) {
+                        auto c = std::find(header.begin(), header.end(), field) - header.begin();
+                        result.push_back(row[c]);
+                    }
+                    return result;
+                };
+                for (auto& r: table) {
+                    for (auto& s: table) {
+                        if (project(r, fd.first) == project(s, fd.first) && 
+                                project(r, fd.second) != project(s, fd.second))
+                            expected.insert(fd);
+                    }
+                }
+            }
+            ASSERT_EQ(validator.violated(), expected);
+            ASSERT_EQ(reported, expected);
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#include "instrumentation.hpp"
+#include "fd_algorithm.hpp"
+#include "normal_form.hpp"
+#include <gmock/gmock.h>
+#include <sstream>
+
+const Field A = "A";
+const Field B = "B";
+const Field C = "C";
+const Field D = "D";
+const Field E = "E";
+
+static FDSet example_fds() {
+    return make_set(
+            make_FD(A, B),
+            make_FD(make_set(A, B), C),
+            make_FD(C, D),
+            make_FD(D, make_set(A, E))
+    );
+}
+
+TEST(instrumentation, counters_and_phases) {
+    reset_algorithm_stats();
+    auto fds = example_fds();
+    closure_of(make_set(A), fds);
+    minimal_cover(fds);
+    convert_3nf(make_set(A, B, C, D, E), fds);
+
+    auto stats = algorithm_stats();
+    if (!instrumentation_enabled) {
+        ASSERT_EQ(stats.closure_calls, 0u);
+        ASSERT_EQ(stats.set_allocations, 0u);
+        ASSERT_EQ(stats.field_set_allocations, 0u);
+        ASSERT_TRUE(stats.phases.empty());
+        return;
+    }
+
+    ASSERT_GT(stats.closure_calls, 0u);
+    ASSERT_GT(stats.fds_scanned, 0u);
+    ASSERT_GT(stats.fixpoint_iterations, 0u);
+    ASSERT_GT(stats.chase_rounds, 0u);
+    ASSERT_GT(stats.row_comparisons, 0u);
+    ASSERT_GT(stats.set_allocations, 0u);
+    ASSERT_GT(stats.field_set_allocations, 0u);
+    ASSERT_EQ(stats.phases["minimal_cover"].calls, 1u);
+    ASSERT_EQ(stats.phases["minimal_cover/left_reduce"].calls, 1u);
+    ASSERT_EQ(stats.phases["convert_3nf"].calls, 1u);
+    ASSERT_EQ(stats.phases["is_lossless_decomposition"].calls, 1u);
+    ASSERT_LE(stats.phases["is_lossless_decomposition/chase"].nanoseconds, 
+            stats.phases["convert_3nf"].nanoseconds);
+
+    reset_algorithm_stats();
+    stats = algorithm_stats();
+    ASSERT_EQ(stats.closure_calls, 0u);
+    ASSERT_TRUE(stats.phases.empty());
+}
+
+TEST(instrumentation, closure_counts) {
+    Schema schema{make_set(A, B, C, D, E)};
+    auto fds = schema.encode(example_fds());
+    reset_algorithm_stats();
+    closure_of(schema.encode(make_set(A)), fds);
+
+    auto stats = algorithm_stats();
+    ASSERT_EQ(stats.closure_calls, instrumentation_enabled ? 1u : 0u);
+    // The index entries of A, B, C and D
+    ASSERT_EQ(stats.fds_scanned, instrumentation_enabled ? 5u : 0u);
+
+    // The copy of {A}, then a new result for each of the 4 FDs fired
+    reset_algorithm_stats();
+    ASSERT_EQ(closure_of(make_set(A), example_fds()), make_set(A, B, C, D, E));
+    stats = algorithm_stats();
+    ASSERT_EQ(stats.field_set_allocations, instrumentation_enabled ? 5u : 0u);
+    ASSERT_EQ(stats.set_allocations, 0u);
+
+    // field_set_from(F), U - F's fields, 4 LHS, 4 RHS, 4 relations
+    reset_algorithm_stats();
+    convert_3nf(make_set(A, B, C, D, E), example_fds());
+    ASSERT_EQ(algorithm_stats().field_set_allocations, instrumentation_enabled ? 14u : 0u);
+}
+
+TEST(instrumentation, chrome_trace) {
+    start_trace();
+    auto fds = example_fds();
+    minimal_cover(fds);
+    convert_3nf(make_set(A, B, C, D, E), fds);
+    stop_trace();
+    minimal_cover(fds);
+
+    std::ostringstream out;
+    write_chrome_trace(out);
+    auto trace = out.str();
+    ASSERT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+    ASSERT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+    if (!instrumentation_enabled) {
+        ASSERT_EQ(trace.find("\"ph\""), std::string::npos);
+        return;
+    }
+
+    auto count = [&trace](const std::string& s) {
+        int result = 0;
+        for (auto p = trace.find(s); p != std::string::npos; p = trace.find(s, p + 1))
+            result++;
+        return result;
+    };
+    // Only the first minimal_cover was traced
+    ASSERT_EQ(count("{\"name\":\"minimal_cover\",\"cat\":\"fd\",\"ph\":\"X\""), 1);
+    ASSERT_EQ(count("\"name\":\"convert_3nf\""), 1);
+    ASSERT_EQ(count("\"ph\":\"C\""), 1);
+    ASSERT_EQ(count("\"closure_calls\":"), 1);
+}
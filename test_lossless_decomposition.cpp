@@ -164,3 +164,110 @@ TEST(lossless_decomposition, is_lossless_decomposition_example4) {
 
     ASSERT_TRUE(is_lossless_decomposition(U, F, R1, R2));
 }
+
+TEST(lossless_decomposition, chase_tableau) {
+    Schema schema{make_set(A, B, C)};
+    std::vector<AttributeSet> relations{
+        schema.encode(make_set(A, B)), schema.encode(make_set(B, C))
+    };
+    ChaseTableau tableau{schema.size(), relations};
+
+    ASSERT_EQ(tableau.symbol(0, 0), tableau.distinguished());
+    ASSERT_EQ(tableau.symbol(0, 2), 0);
+    ASSERT_EQ(tableau.symbol(1, 0), 1);
+    ASSERT_FALSE(tableau.has_distinguished_row());
+
+    ASSERT_TRUE(tableau.apply(schema.encode(make_FD(B, C))));
+    ASSERT_EQ(tableau.symbol(0, 2), tableau.distinguished());
+    ASSERT_TRUE(tableau.has_distinguished_row());
+    ASSERT_FALSE(tableau.apply(schema.encode(make_FD(B, C))));
+}
+
+TEST(lossless_decomposition, is_lossless_decomposition_chain) {
+    std::vector<Field> fields;
+    for (int i = 0; i <= 150; i++) {
+        fields.push_back(Field{"chain_" + std::to_string(i)});
+    }
+
+    FDSet F;
+    std::vector<FieldSet> relations;
+    for (int i = 0; i < 150; i++) {
+        F.insert(make_FD(fields[i + 1], fields[i]));
+        relations.push_back(make_set(fields[i], fields[i + 1]));
+    }
+    FieldSet U{fields.begin(), fields.end()};
+
+    ASSERT_TRUE(is_lossless_decomposition(U, F, relations));
+
+    F.erase(make_FD(fields[76], fields[75]));
+    ASSERT_FALSE(is_lossless_decomposition(U, F, relations));
+}
+
+TEST(lossless_decomposition, packed_tableau) {
+    Schema schema{make_set(A, B, C)};
+    std::vector<AttributeSet> relations{
+        schema.encode(make_set(A, B)), schema.encode(make_set(B, C))
+    };
+    PackedTableau tableau{schema.size(), relations};
+
+    ASSERT_TRUE(tableau.is_distinguished(0, 0));
+    ASSERT_EQ(tableau.symbol(0, 0), PackedTableau::distinguished_symbol);
+    ASSERT_EQ(tableau.symbol(0, 2), 0);
+    ASSERT_FALSE(tableau.is_distinguished(1, 0));
+    ASSERT_FALSE(tableau.has_distinguished_row());
+
+    auto& match = tableau.match_rows(0, std::vector<int>{1});
+    ASSERT_EQ(match[0], 3u);
+
+    ASSERT_TRUE(tableau.apply(schema.encode(make_FD(B, C))));
+    ASSERT_TRUE(tableau.is_distinguished(0, 2));
+    ASSERT_TRUE(tableau.has_distinguished_row());
+    ASSERT_FALSE(tableau.apply(schema.encode(make_FD(B, C))));
+}
+
+TEST(lossless_decomposition, packed_tableau_same_as_chase_tableau) {
+    const int columns = 12;
+    unsigned seed = 99;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    for (int round = 0; round < 40; round++) {
+        std::vector<AttributeSet> relations;
+        int rows = 2 + next() % 90;
+        for (int r = 0; r < rows; r++) {
+            AttributeSet R(columns);
+            for (int k = 0; k < 3; k++)
+                R.insert(next() % columns);
+            relations.push_back(R);
+        }
+
+        AttributeFDSet fds;
+        for (int i = 0; i < 10; i++) {
+            AttributeSet X(columns), Y(columns);
+            X.insert(next() % columns);
+            Y.insert(next() % columns);
+            fds.emplace_back(X, Y);
+        }
+
+        ChaseTableau chase{columns, relations};
+        PackedTableau packed{columns, relations};
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto& fd: fds) {
+                changed = chase.apply(fd) || changed;
+                changed = packed.apply(fd) || changed;
+            }
+        }
+        ASSERT_EQ(chase.has_distinguished_row(), packed.has_distinguished_row());
+
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < columns; c++) {
+                ASSERT_EQ(chase.symbol(r, c) == chase.distinguished(), 
+                        packed.is_distinguished(r, c));
+            }
+        }
+    }
+}
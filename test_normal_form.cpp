@@ -89,3 +89,150 @@ TEST(normal_form, convert_3nf_when_non_lossless_decomposition_empty_remains) {
     ASSERT_TRUE(contains(R_list, make_set(E, F, G)));
     ASSERT_TRUE(contains(R_list, make_set(A, C, D, F)));
 }
+
+static bool is_bcnf(const FieldSet& R, const FDSet& F) {
+    std::vector<Field> fields{R.begin(), R.end()};
+    for (int mask = 0; mask < (1 << fields.size()); mask++) {
+        FieldSet X;
+        for (size_t k = 0; k < fields.size(); k++) {
+            if (mask & (1 << k))
+                X.insert(fields[k]);
+        }
+        auto C = closure_of(X, F) * R;
+        if (C != X && C != R)
+            return false;
+    }
+    return true;
+}
+
+TEST(normal_form, convert_bcnf_lost_fd) {
+    const auto fds = make_set(
+                make_FD(make_set(A, B), C),
+                make_FD(C, B));
+    const auto U = make_set(A, B, C);
+
+    FDSet lost;
+    auto R_list = convert_bcnf(U, fds, lost);
+
+    ASSERT_EQ(R_list.size(), 2);
+    ASSERT_TRUE(contains(R_list, make_set(B, C)));
+    ASSERT_TRUE(contains(R_list, make_set(A, C)));
+    ASSERT_EQ(lost, make_set(make_FD(make_set(A, B), C)));
+}
+
+TEST(normal_form, convert_bcnf_keeps_bcnf_relation) {
+    const auto fds = make_set(
+                make_FD(A, make_set(B, C)),
+                make_FD(make_set(B, C), D),
+                make_FD(D, A));
+    const auto U = make_set(A, B, C, D);
+
+    FDSet lost;
+    auto R_list = convert_bcnf(U, fds, lost);
+    ASSERT_EQ(R_list, std::vector<FieldSet>{U});
+    ASSERT_TRUE(lost.empty());
+}
+
+TEST(normal_form, convert_bcnf_problem) {
+    std::stringstream input{
+        "A BCD\n"
+        "CD B\n"
+        "EF GH\n"
+        "E GIJ\n"
+        "I J\n"
+    };
+    FDSet fds;
+    input >> fds;
+    const auto U = field_set_from(fds) + make_set(H);
+
+    FDSet lost;
+    auto R_list = convert_bcnf(U, fds, lost);
+
+    ASSERT_TRUE(is_lossless_decomposition(U, fds, R_list));
+    for (auto& R: R_list) {
+        ASSERT_TRUE(is_bcnf(R, fds));
+    }
+    for (auto& fd: lost) {
+        ASSERT_TRUE(fds.count(fd));
+    }
+}
+
+TEST(normal_form, convert_bcnf_implied_violation) {
+    // B -> D only follows through C, which is split off first
+    const auto fds = make_set(
+                make_FD(B, C),
+                make_FD(C, D),
+                make_FD(make_set(A, D), E));
+    const auto U = make_set(A, B, C, D, E);
+
+    auto R_list = convert_bcnf(U, fds);
+
+    ASSERT_TRUE(is_lossless_decomposition(U, fds, R_list));
+    for (auto& R: R_list) {
+        ASSERT_TRUE(is_bcnf(R, fds));
+    }
+}
+
+TEST(normal_form, convert_bcnf_random) {
+    const std::vector<Field> fields{A, B, C, D, E, F, G};
+    const FieldSet U{fields.begin(), fields.end()};
+    unsigned seed = 2024;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+
+    for (int round = 0; round < 40; round++) {
+        FDSet fds;
+        for (int i = 0; i < 5; i++) {
+            FieldSet X, Y;
+            for (int k = 0; k < 2; k++)
+                X.insert(fields[next() % fields.size()]);
+            Y.insert(fields[next() % fields.size()]);
+            fds.insert(make_FD(X, Y));
+        }
+
+        FDSet lost;
+        auto R_list = convert_bcnf(U, fds, lost);
+        ASSERT_TRUE(is_lossless_decomposition(U, fds, R_list));
+        for (auto& R: R_list) {
+            ASSERT_TRUE(is_bcnf(R, fds));
+        }
+    }
+}
+
+TEST(normal_form, is_dependency_preserving) {
+    const auto fds = make_set(
+                make_FD(A, B),
+                make_FD(B, C),
+                make_FD(C, A));
+
+    ASSERT_TRUE(is_dependency_preserving(fds, {make_set(A, B), make_set(B, C), make_set(C, A)}));
+    // C -> A follows from C -> B and B -> A in the projections
+    ASSERT_TRUE(is_dependency_preserving(fds, {make_set(A, B), make_set(B, C)}));
+    ASSERT_TRUE(is_dependency_preserving(fds, {make_set(A, B), make_set(A, C)}));
+    ASSERT_FALSE(is_dependency_preserving(fds, {make_set(A, B), make_set(C)}));
+
+    const auto fds2 = make_set(
+                make_FD(make_set(A, B), C),
+                make_FD(C, B));
+    ASSERT_FALSE(is_dependency_preserving(fds2, {make_set(B, C), make_set(A, C)}));
+    ASSERT_TRUE(is_dependency_preserving(fds2, {make_set(A, B, C)}));
+}
+
+TEST(normal_form, convert_3nf_is_dependency_preserving) {
+    std::stringstream input{
+        "A C\n"
+        "A D\n"
+        "CD B\n"
+        "E G\n"
+        "EF H\n"
+        "E I\n"
+        "I J\n"
+    };
+    FDSet fds;
+    input >> fds;
+    const auto U = field_set_from(fds) + make_set(Field{"K"});
+
+    ASSERT_TRUE(is_dependency_preserving(fds, convert_3nf(U, fds)));
+}
@@ -0,0 +1,102 @@
+#include "static_schema.hpp"
+#include "fd_algorithm.hpp"
+#include "lossless_decomposition.hpp"
+#include <gmock/gmock.h>
+
+using S = StaticSchema<6>;
+
+// A -> B, BC -> D, D -> E, E -> A
+constexpr auto fds = S::fds(
+        S::fd(S::set(0), S::set(1)),
+        S::fd(S::set(1, 2), S::set(3)),
+        S::fd(S::set(3), S::set(4)),
+        S::fd(S::set(4), S::set(0))
+);
+
+static_assert(S::all() == 0x3f, "");
+static_assert(StaticSchema<64>::all() == ~std::uint64_t{0}, "");
+static_assert(S::closure(S::set(0), fds) == S::set(0, 1), "");
+static_assert(S::closure(S::set(0, 2), fds) == S::set(0, 1, 2, 3, 4), "");
+static_assert(S::closure(S::set(5), fds) == S::set(5), "");
+static_assert(S::implies(fds, S::fd(S::set(2, 3), S::set(0, 1))), "");
+static_assert(!S::implies(fds, S::fd(S::set(0), S::set(2))), "");
+static_assert(S::candidate_key(fds) == S::set(2, 4, 5), "");
+static_assert(S::is_lossless_decomposition(fds, S::set(0, 1), S::set(0, 2, 3, 4, 5)), "");
+static_assert(!S::is_lossless_decomposition(fds, S::set(0, 1), S::set(2, 3, 4, 5)), "");
+
+static AttributeSet to_attribute_set(S::Set set) {
+    AttributeSet result(S::size);
+    for (int id = 0; id < S::size; id++) {
+        if (S::contains(set, id))
+            result.insert(id);
+    }
+    return result;
+}
+
+TEST(static_schema, empty_lhs_ignored) {
+    constexpr auto with_empty = S::fds(S::fd(S::set(), S::set(0)), S::fd(S::set(0), S::set(1)));
+    static_assert(S::closure(S::set(2), with_empty) == S::set(2), "");
+    ASSERT_EQ(S::closure(S::set(), with_empty), S::set());
+}
+
+TEST(static_schema, empty_lhs_in_chase) {
+    // Lossless only because the attributes of R2 are constant
+    constexpr auto constant = S::fds(S::fd(S::set(), S::set(3, 4, 5)));
+    static_assert(S::is_lossless_decomposition(constant, S::set(0, 1, 2), S::set(3, 4, 5)), "");
+    static_assert(!S::is_lossless_decomposition(fds, S::set(0, 1, 2), S::set(3, 4, 5)), "");
+
+    const std::vector<Field> fields{"A", "B", "C", "D", "E", "F"};
+    Schema schema{FieldSet(fields.begin(), fields.end())};
+    AttributeFDSet encoded{{to_attribute_set(0), to_attribute_set(S::set(3, 4, 5))}};
+    ASSERT_TRUE(is_lossless_decomposition(schema.decode(schema.all()), schema.decode(encoded), 
+            std::vector<FieldSet>{
+                schema.decode(to_attribute_set(S::set(0, 1, 2))),
+                schema.decode(to_attribute_set(S::set(3, 4, 5)))}));
+}
+
+TEST(static_schema, same_as_attribute_set_versions) {
+    const std::vector<Field> fields{"A", "B", "C", "D", "E", "F"};
+    Schema schema{FieldSet(fields.begin(), fields.end())};
+    unsigned seed = 31;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7fff;
+    };
+    auto random_set = [&next](int max_size) {
+        S::Set result = 0;
+        int count = 1 + next() % max_size;
+        for (int k = 0; k < count; k++)
+            result |= S::set(next() % S::size);
+        return result;
+    };
+
+    for (int round = 0; round < 200; round++) {
+        S::FDSet<5> random_fds{};
+        AttributeFDSet encoded;
+        for (auto& fd: random_fds) {
+            fd = S::fd(next() % 8 == 0 ? 0 : random_set(2), random_set(2));
+            encoded.emplace_back(to_attribute_set(fd.lhs), to_attribute_set(fd.rhs));
+        }
+
+        auto X = random_set(3);
+        ASSERT_EQ(to_attribute_set(S::closure(X, random_fds)), 
+                closure_of(to_attribute_set(X), encoded));
+        ASSERT_EQ(to_attribute_set(S::candidate_key(random_fds)), 
+                candidate_key(schema.all(), encoded));
+
+        auto R1 = random_set(4);
+        auto R2 = random_set(4);
+        auto R3 = S::all() & ~(R1 | R2);
+        std::vector<FieldSet> relations{
+            schema.decode(to_attribute_set(R1)), 
+            schema.decode(to_attribute_set(R2))
+        };
+        if (R3)
+            relations.push_back(schema.decode(to_attribute_set(R3)));
+        bool lossless = R3 ? 
+            S::is_lossless_decomposition(random_fds, R1, R2, R3) : 
+            S::is_lossless_decomposition(random_fds, R1, R2);
+        ASSERT_EQ(lossless, is_lossless_decomposition(schema.decode(schema.all()), 
+                    schema.decode(encoded), relations));
+    }
+}
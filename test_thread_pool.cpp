@@ -0,0 +1,47 @@
+#include "thread_pool.hpp"
+#include <gmock/gmock.h>
+#include <atomic>
+#include <stdexcept>
+
+TEST(thread_pool, parallel_for_visits_every_index_once) {
+    ThreadPool pool{4};
+    ASSERT_EQ(pool.thread_count(), 4);
+
+    for (int count: {0, 1, 3, 1000}) {
+        std::vector<std::atomic<int>> visits(count);
+        for (auto& v: visits) {
+            v = 0;
+        }
+        std::atomic<bool> worker_in_range{true};
+        pool.parallel_for(count, [&](int i, int worker) {
+            visits[i]++;
+            if (worker < 0 || worker >= pool.thread_count())
+                worker_in_range = false;
+        });
+        for (auto& v: visits) {
+            ASSERT_EQ(v, 1);
+        }
+        ASSERT_TRUE(worker_in_range);
+    }
+}
+
+TEST(thread_pool, single_thread_runs_inline) {
+    ThreadPool pool{1};
+    auto caller = std::this_thread::get_id();
+    pool.parallel_for(10, [&](int, int worker) {
+        ASSERT_EQ(worker, 0);
+        ASSERT_EQ(std::this_thread::get_id(), caller);
+    });
+}
+
+TEST(thread_pool, rethrows_exception) {
+    ThreadPool pool{3};
+    ASSERT_THROW(pool.parallel_for(100, [](int i, int) {
+        if (i == 57)
+            throw std::runtime_error{"failed"};
+    }), std::runtime_error);
+
+    std::atomic<int> sum{0};
+    pool.parallel_for(100, [&](int i, int) { sum += i; });
+    ASSERT_EQ(sum, 4950);
+}
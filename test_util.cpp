@@ -250,3 +250,38 @@ TEST(util, operator_minus_assign) {
     set -= make_set(Z, A);
     ASSERT_EQ(set, compared_set);
 }
+
+TEST(util, field_interning) {
+    Field X1 = "field_interning_X";
+    Field X2 = std::string{"field_interning_X"};
+    Field Y = "field_interning_Y";
+
+    ASSERT_EQ(X1, X2);
+    ASSERT_EQ(X1.id(), X2.id());
+    ASSERT_NE(X1, Y);
+    ASSERT_TRUE(X1 < Y);
+    ASSERT_EQ(Y.name(), "field_interning_Y");
+    ASSERT_EQ(Field{}.name(), "");
+
+    Field moved = std::move(Y);
+    ASSERT_EQ(moved.name(), "field_interning_Y");
+
+    std::stringstream ss;
+    ss << X1;
+    ASSERT_EQ(ss.str(), "field_interning_X");
+}
+
+TEST(util, field_order_by_name) {
+    // Interned in reverse name order
+    Field B = "field_order_B";
+    Field A = "field_order_A";
+
+    ASSERT_TRUE(A < B);
+    ASSERT_FALSE(B < A);
+    ASSERT_FALSE(A < A);
+    ASSERT_TRUE(Field{} < A);
+
+    std::stringstream ss;
+    ss << make_set(make_FD(B, A), make_FD(A, B));
+    ASSERT_EQ(ss.str(), "field_order_A field_order_B\nfield_order_B field_order_A\n");
+}
@@ -0,0 +1,121 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int thread_count) {
+    if (thread_count <= 0)
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 0; i < thread_count; i++) {
+        queues_.emplace_back(new Queue{});
+    }
+    for (int i = 1; i < thread_count; i++) {
+        threads_.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread: threads_) {
+        thread.join();
+    }
+}
+
+bool ThreadPool::pop(int worker, Range& range) {
+    {
+        auto& own = *queues_[worker];
+        std::lock_guard<std::mutex> lock{own.mutex};
+        if (!own.ranges.empty()) {
+            range = own.ranges.back();
+            own.ranges.pop_back();
+            return true;
+        }
+    }
+    for (int i = 1; i < thread_count(); i++) {
+        auto& victim = *queues_[(worker + i) % thread_count()];
+        std::lock_guard<std::mutex> lock{victim.mutex};
+        if (!victim.ranges.empty()) {
+            range = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(int worker) {
+    Range range;
+    while (pop(worker, range)) {
+        try {
+            for (int i = range.first; i < range.second; i++) {
+                (*task_)(i, worker);
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (!error_)
+                error_ = std::current_exception();
+        }
+    }
+}
+
+void ThreadPool::worker_loop(int worker) {
+    std::size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+            busy_++;
+        }
+        run(worker);
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (--busy_ == 0)
+                done_.notify_all();
+        }
+    }
+}
+
+void ThreadPool::parallel_for(int count, const Task& f) {
+    if (count <= 0)
+        return;
+    if (thread_count() == 1) {
+        for (int i = 0; i < count; i++) {
+            f(i, 0);
+        }
+        return;
+    }
+
+    // A few chunks per worker leave room for stealing
+    int chunk = std::max(1, count / (thread_count() * 8));
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        task_ = &f;
+        int worker = 0;
+        for (int begin = 0; begin < count; begin += chunk) {
+            auto& queue = *queues_[worker];
+            std::lock_guard<std::mutex> queue_lock{queue.mutex};
+            queue.ranges.emplace_back(begin, std::min(count, begin + chunk));
+            worker = (worker + 1) % thread_count();
+        }
+        generation_++;
+    }
+    wake_.notify_all();
+
+    run(0);
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    done_.wait(lock, [&] { return busy_ == 0; });
+    task_ = nullptr;
+    if (error_) {
+        auto error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef DB_THREAD_POOL_HPP
+#define DB_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fixed set of workers for data-parallel loops.
+// parallel_for splits the index range into chunks dealt to per-worker
+// queues; a worker takes chunks from the back of its own queue and steals
+// from the front of the others when it runs dry. The calling thread is
+// worker 0, so a pool of one thread runs everything inline.
+// Calls must not be nested or made from several threads at once.
+class ThreadPool {
+public:
+    // f(index, worker) is called once for every index in [0, count),
+    // worker is in [0, thread_count()) and can select per-thread scratch.
+    using Task = std::function<void(int index, int worker)>;
+
+private:
+    using Range = std::pair<int, int>;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const Task *task_ = nullptr;
+    std::size_t generation_ = 0;
+    int busy_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+
+    bool pop(int worker, Range& range);
+
+    void run(int worker);
+
+    void worker_loop(int worker);
+
+public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(int thread_count = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator = (const ThreadPool&) = delete;
+
+    int thread_count() const {
+        return static_cast<int>(queues_.size());
+    }
+
+    // Blocks until every index is done, rethrows the first exception of f.
+    void parallel_for(int count, const Task& f);
+};
+
+#endif
@@ -1,4 +1,43 @@
 #include "util.hpp"
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace detail {
+
+namespace {
+
+struct SymbolTable {
+    std::mutex mutex;
+    std::deque<Symbol> symbols{Symbol{"", 0}};
+    std::unordered_map<std::string, const Symbol *> by_name{{"", &symbols.front()}};
+};
+
+SymbolTable& symbol_table() {
+    static SymbolTable table;
+    return table;
+}
+
+} // namespace
+
+const Symbol *intern_symbol(const std::string& name) {
+    auto& table = symbol_table();
+    std::lock_guard<std::mutex> lock{table.mutex};
+    auto it = table.by_name.find(name);
+    if (it != table.by_name.end())
+        return it->second;
+
+    table.symbols.push_back(Symbol{name, static_cast<int>(table.symbols.size())});
+    const Symbol *symbol = &table.symbols.back();
+    table.by_name.emplace(name, symbol);
+    return symbol;
+}
+
+const Symbol *empty_symbol() {
+    return &symbol_table().symbols.front();
+}
+
+} // namespace detail
 
 FieldSet field_set_from(const FDSet& set) {
     FieldSet result;
@@ -19,7 +58,7 @@ FieldSet field_set_from(FDSet&& set) {
 
 // Field
 std::ostream& operator << (std::ostream& out, const Field& field) {
-    out << field.string_;
+    out << field.name();
     return out;
 }
 
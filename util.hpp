@@ -8,52 +8,59 @@
 template <typename T>
 using Set = std::set<T>;
 
+namespace detail {
+
+struct Symbol {
+    std::string name;
+    int id;
+};
+
+// Global symbol table for field names, safe to use from several threads.
+// Symbols are never freed, so their names can be read without locking.
+// Symbol 0 is the empty name.
+const Symbol *intern_symbol(const std::string& name);
+
+const Symbol *empty_symbol();
+
+} // namespace detail
+
+// A field is a handle to an interned name: copy and equality are O(1).
+// Fields are ordered by name, as strings would be, so the order of sets
+// and results does not depend on which names were interned first.
+// The name comparison is skipped for equal fields.
 class Field {
 private:
     friend std::istream& operator >> (std::istream& in, Field& field);
     friend std::ostream& operator << (std::ostream& out, const Field& field);
 
-    std::string string_;
+    const detail::Symbol *symbol_ = detail::empty_symbol();
 
 public:
-    Field(const char *s): string_{s} {}
+    Field(const char *s): symbol_{detail::intern_symbol(s)} {}
 
-    Field(std::string s): string_{std::move(s)} {}
+    Field(const std::string& s): symbol_{detail::intern_symbol(s)} {}
 
     Field() = default;
 
-    Field(const Field& other) {
-        string_ = other.string_;
+    // Dense number of the name, in interning order
+    int id() const {
+        return symbol_->id;
     }
 
-    Field(Field&& other) {
-        string_ = other.string_;
+    const std::string& name() const {
+        return symbol_->name;
     }
 
     bool operator == (const Field& other) const {
-        return string_ == other.string_;
+        return symbol_ == other.symbol_;
     }
 
-    bool operator == (Field&& other) const {
-        return string_ == other.string_;
+    bool operator != (const Field& other) const {
+        return symbol_ != other.symbol_;
     }
 
     bool operator < (const Field& other) const {
-        return string_ < other.string_;
-    }
-
-    bool operator < (Field&& other) const {
-        return string_ < other.string_;
-    }
-
-    Field& operator = (const Field& other) {
-        string_ = other.string_;
-        return *this;
-    }
-
-    Field& operator = (Field&& other) {
-        string_ = other.string_;
-        return *this;
+        return symbol_ != other.symbol_ && symbol_->name < other.symbol_->name;
     }
 
     operator Set<Field>() const {